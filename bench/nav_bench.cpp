@@ -0,0 +1,368 @@
+#include "astar.hpp"
+#include "component.hpp"
+#include "def_manager.hpp"
+#include "profiler.hpp"
+#include "station.hpp"
+#include "tile.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+
+#ifndef CELESTIUM_COUNT_ALLOCATIONS
+// Global allocation counter, used to verify that path queries do not allocate
+static std::atomic<uint64_t> allocationCount = 0;
+
+void *operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+#endif
+
+// Allocations made by this thread so far, for comparing before and after a run
+static uint64_t CountAllocations()
+{
+#ifdef CELESTIUM_COUNT_ALLOCATIONS
+    // The profiler already replaces operator new, so count through a section this thread stays in
+    static const size_t section = Profiler::AddSection("NavBench", ProfileDomain::FRAME);
+    Profiler::SwapCurrentSection(section);
+    return Profiler::GetAllocationTotal(section).count;
+#else
+    return allocationCount.load(std::memory_order_relaxed);
+#endif
+}
+
+/**
+ * @brief A generated station layout. Cells are '#' for walls, '.' for floor, 'D' for doors
+ * and ' ' for empty space.
+ */
+struct Layout
+{
+    std::string name;
+    int width, height;
+    std::vector<char> cells;
+
+    Layout(const std::string &name, int width, int height) : name(name), width(width), height(height), cells(width * height, '#') {}
+
+    char &At(int x, int y) { return cells[y * width + x]; }
+    char At(int x, int y) const { return cells[y * width + x]; }
+
+    // Turns walls that do not touch any floor into empty space
+    void TrimWalls()
+    {
+        std::vector<char> trimmed = cells;
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x)
+            {
+                if (At(x, y) != '#')
+                    continue;
+                bool touchesFloor = false;
+                for (int dy = -1; dy <= 1 && !touchesFloor; ++dy)
+                    for (int dx = -1; dx <= 1; ++dx)
+                    {
+                        int nx = x + dx, ny = y + dy;
+                        if (nx >= 0 && ny >= 0 && nx < width && ny < height && At(nx, ny) != '#')
+                        {
+                            touchesFloor = true;
+                            break;
+                        }
+                    }
+                if (!touchesFloor)
+                    trimmed[y * width + x] = ' ';
+            }
+        cells = std::move(trimmed);
+    }
+};
+
+// Grid of square rooms sharing walls, with a door in the middle of every inner wall
+static Layout GenerateRoomGrid(int roomsX, int roomsY, int roomSize)
+{
+    const int stride = roomSize - 1;
+    Layout layout(std::format("room_grid_{}x{}_s{}", roomsX, roomsY, roomSize), roomsX * stride + 1, roomsY * stride + 1);
+
+    for (int y = 0; y < layout.height; ++y)
+        for (int x = 0; x < layout.width; ++x)
+            if (x % stride != 0 && y % stride != 0)
+                layout.At(x, y) = '.';
+
+    for (int ry = 0; ry < roomsY; ++ry)
+        for (int rx = 0; rx < roomsX; ++rx)
+        {
+            if (rx > 0)
+                layout.At(rx * stride, ry * stride + stride / 2) = 'D';
+            if (ry > 0)
+                layout.At(rx * stride + stride / 2, ry * stride) = 'D';
+        }
+    return layout;
+}
+
+// Long corridors branching off a vertical spine, each behind a door
+static Layout GenerateCorridors(int count, int length)
+{
+    Layout layout(std::format("corridors_{}x{}", count, length), length + 4, count * 4 + 1);
+
+    for (int y = 1; y < layout.height - 1; ++y)
+        layout.At(1, y) = '.';
+
+    for (int i = 0; i < count; ++i)
+    {
+        int y = 2 + i * 4;
+        layout.At(2, y) = 'D';
+        for (int x = 3; x < layout.width - 1; ++x)
+            layout.At(x, y) = '.';
+    }
+
+    layout.TrimWalls();
+    return layout;
+}
+
+// Perfect maze of one-tile corridors, carved with a depth-first search
+static Layout GenerateMaze(int cellsX, int cellsY, uint32_t seed)
+{
+    Layout layout(std::format("maze_{}x{}", cellsX, cellsY), cellsX * 2 + 1, cellsY * 2 + 1);
+    std::mt19937 rng(seed);
+
+    std::vector<Vector2Int> stack = {{0, 0}};
+    layout.At(1, 1) = '.';
+
+    while (!stack.empty())
+    {
+        Vector2Int cur = stack.back();
+        Vector2Int options[4];
+        int optionCount = 0;
+
+        for (const auto &dir : CARDINAL_DIRECTIONS)
+        {
+            Vector2Int nb = cur + DirectionToVector2Int(dir);
+            if (nb.x >= 0 && nb.y >= 0 && nb.x < cellsX && nb.y < cellsY && layout.At(nb.x * 2 + 1, nb.y * 2 + 1) == '#')
+                options[optionCount++] = nb;
+        }
+
+        if (optionCount == 0)
+        {
+            stack.pop_back();
+            continue;
+        }
+
+        Vector2Int next = options[rng() % optionCount];
+        layout.At(cur.x + next.x + 1, cur.y + next.y + 1) = '.';
+        layout.At(next.x * 2 + 1, next.y * 2 + 1) = '.';
+        stack.push_back(next);
+    }
+    return layout;
+}
+
+// One large room with a regular grid of pillars
+static Layout GenerateOpenHall(int size, int pillarSpacing)
+{
+    Layout layout(std::format("open_hall_{}_p{}", size, pillarSpacing), size, size);
+
+    for (int y = 1; y < size - 1; ++y)
+        for (int x = 1; x < size - 1; ++x)
+        {
+            bool isPillar = pillarSpacing > 0 && x % pillarSpacing == 0 && y % pillarSpacing == 0;
+            layout.At(x, y) = isPillar ? '#' : '.';
+        }
+    return layout;
+}
+
+static std::shared_ptr<Station> CreateStationFromLayout(const Layout &layout, std::vector<Vector2> &floorPositions)
+{
+    auto station = std::make_shared<Station>();
+    floorPositions.clear();
+
+    for (int y = 0; y < layout.height; ++y)
+        for (int x = 0; x < layout.width; ++x)
+        {
+            Vector2Int pos = {x, y};
+            switch (layout.At(x, y))
+            {
+            case '#':
+                Tile::CreateTile("WALL", pos, station, true, false);
+                break;
+            case '.':
+                Tile::CreateTile("BLUE_FLOOR", pos, station, true, false);
+                floorPositions.push_back(ToVector2(pos));
+                break;
+            case 'D':
+                Tile::CreateTile("BLUE_FLOOR", pos, station, true, false);
+                // Doors are only pathable while powered
+                if (auto door = Tile::CreateTile("DOOR", pos, station, true, false))
+                    if (auto consumer = door->GetComponent<PowerConsumerComponent>())
+                        consumer->SetActive(true);
+                break;
+            default:
+                break;
+            }
+        }
+    return station;
+}
+
+struct Percentiles
+{
+    double mean, p50, p90, p99, max;
+};
+
+static Percentiles ComputePercentiles(std::vector<double> &samples)
+{
+    if (samples.empty())
+        return {};
+
+    std::sort(samples.begin(), samples.end());
+    auto at = [&samples](double q)
+    { return samples[std::min(samples.size() - 1, (size_t)(q * (double)samples.size()))]; };
+
+    double sum = 0.;
+    for (double s : samples)
+        sum += s;
+    return {sum / (double)samples.size(), at(.5), at(.9), at(.99), samples.back()};
+}
+
+static std::string BenchmarkLayout(const Layout &layout, int buildRepeats, int queryCount, uint32_t seed)
+{
+    using Clock = std::chrono::steady_clock;
+    std::vector<Vector2> floorPositions;
+    auto station = CreateStationFromLayout(layout, floorPositions);
+
+    std::string result = std::format("    {{\n      \"layout\": \"{}\",\n      \"width\": {},\n      \"height\": {},\n      \"floorTiles\": {},\n      \"decompositions\": [\n",
+                                     layout.name, layout.width, layout.height, floorPositions.size());
+
+    constexpr NavDecomposition decompositions[] = {NavDecomposition::GREEDY, NavDecomposition::MAX_RECT};
+    for (size_t d = 0; d < std::size(decompositions); ++d)
+    {
+        station->navDecomposition = decompositions[d];
+
+        std::vector<double> buildMs;
+        for (int i = 0; i < buildRepeats; ++i)
+        {
+            auto start = Clock::now();
+            station->RebuildNavigationGraph();
+            buildMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        }
+        Percentiles build = ComputePercentiles(buildMs);
+
+        // Same query pairs for every decomposition
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<size_t> pick(0, floorPositions.empty() ? 0 : floorPositions.size() - 1);
+        std::vector<std::pair<Vector2, Vector2>> queries(queryCount);
+        for (auto &q : queries)
+            q = {floorPositions[pick(rng)], floorPositions[pick(rng)]};
+
+        auto &pathfinder = Pathfinder::ForCurrentThread();
+        std::vector<Vector2> path;
+        path.reserve(1024);
+
+        // Warm-up pass so scratch buffers reach their steady-state size
+        for (const auto &[from, to] : queries)
+            pathfinder.FindPath(station->navGraph, from, to, path);
+
+        std::vector<double> queryUs;
+        queryUs.reserve(queries.size());
+        int found = 0;
+        uint64_t allocationsBefore = CountAllocations();
+        for (const auto &[from, to] : queries)
+        {
+            auto start = Clock::now();
+            found += pathfinder.FindPath(station->navGraph, from, to, path) ? 1 : 0;
+            queryUs.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+        }
+        uint64_t allocations = CountAllocations() - allocationsBefore;
+        Percentiles query = ComputePercentiles(queryUs);
+
+        result += std::format("        {{\n"
+                              "          \"decomposition\": \"{}\",\n"
+                              "          \"polygons\": {},\n"
+                              "          \"links\": {},\n"
+                              "          \"buildMs\": {{\"mean\": {:.4f}, \"p50\": {:.4f}, \"max\": {:.4f}}},\n"
+                              "          \"queries\": {},\n"
+                              "          \"found\": {},\n"
+                              "          \"queryUs\": {{\"mean\": {:.4f}, \"p50\": {:.4f}, \"p90\": {:.4f}, \"p99\": {:.4f}, \"max\": {:.4f}}},\n"
+                              "          \"allocationsPerQuery\": {:.4f}\n"
+                              "        }}{}\n",
+                              magic_enum::enum_name(decompositions[d]), station->navPolygons.size(), station->navGraph.GetLinkCount(),
+                              build.mean, build.p50, build.max, queries.size(), found,
+                              query.mean, query.p50, query.p90, query.p99, query.max,
+                              queries.empty() ? 0. : (double)allocations / (double)queries.size(),
+                              d + 1 < std::size(decompositions) ? "," : "");
+    }
+
+    result += "      ]\n    }";
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    std::string definitionsDir = "../assets/definitions";
+    std::string outputPath;
+    int queryCount = 2000;
+    int buildRepeats = 5;
+    uint32_t seed = 1;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--definitions" && hasValue)
+            definitionsDir = argv[++i];
+        else if (arg == "--out" && hasValue)
+            outputPath = argv[++i];
+        else if (arg == "--queries" && hasValue)
+            queryCount = std::max(std::atoi(argv[++i]), 1);
+        else if (arg == "--builds" && hasValue)
+            buildRepeats = std::max(std::atoi(argv[++i]), 1);
+        else if (arg == "--seed" && hasValue)
+            seed = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+        else
+        {
+            std::cerr << "Usage: nav_bench [--definitions DIR] [--out FILE] [--queries N] [--builds N] [--seed N]\n";
+            return 1;
+        }
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+    DefinitionManager::ParseConstantsFromFile(definitionsDir + "/constants.yml");
+    DefinitionManager::ParseResourcesFromFile(definitionsDir + "/resources.yml");
+    DefinitionManager::ParseTilesFromFile(definitionsDir + "/tiles.yml");
+
+    const std::vector<Layout> layouts = {
+        GenerateRoomGrid(4, 4, 9),
+        GenerateRoomGrid(10, 10, 12),
+        GenerateCorridors(8, 60),
+        GenerateCorridors(24, 150),
+        GenerateMaze(15, 15, seed),
+        GenerateMaze(40, 40, seed),
+        GenerateOpenHall(40, 0),
+        GenerateOpenHall(100, 6),
+    };
+
+    std::string json = std::format("{{\n  \"seed\": {},\n  \"queriesPerLayout\": {},\n  \"results\": [\n", seed, queryCount);
+    for (size_t i = 0; i < layouts.size(); ++i)
+    {
+        json += BenchmarkLayout(layouts[i], buildRepeats, queryCount, seed);
+        json += i + 1 < layouts.size() ? ",\n" : "\n";
+    }
+    json += "  ]\n}\n";
+
+    if (outputPath.empty())
+    {
+        std::cout << json;
+        return 0;
+    }
+
+    std::ofstream out(outputPath);
+    if (!out)
+    {
+        std::cerr << "Failed to open " << outputPath << "\n";
+        return 1;
+    }
+    out << json;
+    return 0;
+}
@@ -0,0 +1,211 @@
+#include "def_manager.hpp"
+#include "game_server.hpp"
+#include "pawn.hpp"
+#include "replay.hpp"
+#include "station.hpp"
+#include "telemetry.hpp"
+#include "tracer.hpp"
+#include <chrono>
+#include <iostream>
+
+/**
+ * @brief Adds pawns spread evenly over the station's floor tiles, in a fixed order so runs are repeatable.
+ */
+static void AddExtraPawns(GameServer &server, int count)
+{
+    auto station = server.GetStation();
+    if (!station || count <= 0)
+        return;
+
+    // Walkable cells, the nav graph leaves out anything blocked by walls or machines
+    std::vector<Vector2Int> floors;
+    for (const auto &[pos, tiles] : station->tileMap)
+        if (station->navGraph.FindPolygonAt(ToVector2(pos)) >= 0)
+            floors.push_back(pos);
+
+    if (floors.empty())
+        return;
+
+    std::ranges::sort(floors, [](const Vector2Int &a, const Vector2Int &b)
+                      { return a.x != b.x ? a.x < b.x : a.y < b.y; });
+
+    for (int i = 0; i < count; ++i)
+        server.GetPawns().Add(std::make_shared<Pawn>(std::format("PAWN_{}", i), WHITE), ToVector2(floors[i % floors.size()]));
+}
+
+int main(int argc, char **argv)
+{
+    std::string definitionsDir = "../assets/definitions";
+    int tickCount = 1000;
+    bool hasTickCount = false;
+    int extraPawns = 0;
+    uint64_t seed = 0;
+    std::string telemetryPath;
+    std::string tracePath;
+    std::string replayPath;
+    int hashInterval = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--definitions" && hasValue)
+            definitionsDir = argv[++i];
+        else if (arg == "--ticks" && hasValue)
+        {
+            tickCount = std::max(std::atoi(argv[++i]), 0);
+            hasTickCount = true;
+        }
+        else if (arg == "--pawns" && hasValue)
+            extraPawns = std::max(std::atoi(argv[++i]), 0);
+        else if (arg == "--seed" && hasValue)
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--telemetry" && hasValue)
+            telemetryPath = argv[++i];
+        else if (arg == "--trace" && hasValue)
+            tracePath = argv[++i];
+        else if (arg == "--replay" && hasValue)
+            replayPath = argv[++i];
+        else if (arg == "--hash-interval" && hasValue)
+            hashInterval = std::max(std::atoi(argv[++i]), 0);
+        else
+        {
+            std::cerr << "Usage: celestium_headless [--definitions DIR] [--ticks N] [--pawns N] [--seed N] [--telemetry FILE] [--trace FILE]\n"
+                      << "                          [--replay FILE] [--hash-interval N]\n";
+            return 1;
+        }
+    }
+
+    if (!replayPath.empty() && extraPawns > 0)
+    {
+        std::cerr << "--pawns cannot be combined with --replay, the replay needs the world it was recorded in\n";
+        return 1;
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+    DefinitionManager::ParseConstantsFromFile(definitionsDir + "/constants.yml");
+    DefinitionManager::ParseResourcesFromFile(definitionsDir + "/resources.yml");
+    DefinitionManager::ParseTilesFromFile(definitionsDir + "/tiles.yml");
+    DefinitionManager::ParseEffectsFromFile(definitionsDir + "/env_effects.yml");
+    DefinitionManager::ParsePawnsFromFile(definitionsDir + "/pawns.yml");
+
+    // A replay brings its own seed and length, the length can still be cut short with --ticks
+    std::optional<Replay> replay;
+    if (!replayPath.empty())
+    {
+        try
+        {
+            replay = Replay::Load(replayPath);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << e.what() << "\n";
+            return 1;
+        }
+        seed = replay->seed;
+        if (!hasTickCount)
+            tickCount = (int)replay->tickCount;
+        if (replay->definitionsHash != DefinitionManager::GetDefinitionsHash())
+            std::cerr << "Warning: the replay was recorded with different definitions, it will likely diverge\n";
+    }
+
+    if (telemetryPath.empty())
+        telemetryPath = TELEMETRY_PATH;
+    if (!telemetryPath.empty())
+    {
+        try
+        {
+            TelemetrySink::Start(telemetryPath, TELEMETRY_INTERVAL);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << e.what() << ", running without telemetry\n";
+        }
+    }
+
+    Tracer::SetThreadName("Simulation");
+
+    GameServer server;
+    server.Initialize();
+    server.SetWorldSeed(seed);
+    server.PrepareTestWorld();
+    AddExtraPawns(server, extraPawns);
+
+    std::optional<ReplayPlayer> player;
+    if (replay)
+    {
+        try
+        {
+            player.emplace(*replay, server);
+        }
+        catch (const std::exception &e)
+        {
+            TelemetrySink::Stop();
+            std::cerr << e.what() << "\n";
+            return 1;
+        }
+    }
+    std::optional<int> divergedTick;
+    std::vector<StateHash> stateHashes;
+
+    // Tick on this thread as fast as possible, nothing else touches the server
+    using Clock = std::chrono::steady_clock;
+    Clock::duration longestTick = Clock::duration::zero();
+    // Only the ticks are traced, world setup would crowd out the start of the run
+    if (!tracePath.empty())
+    {
+        try
+        {
+            Tracer::Start(tracePath);
+        }
+        catch (const std::exception &e)
+        {
+            TelemetrySink::Stop();
+            std::cerr << e.what() << "\n";
+            return 1;
+        }
+    }
+    auto start = Clock::now();
+    for (int tick = 0; tick < tickCount; ++tick)
+    {
+        if (player)
+            player->QueueCommands(server);
+
+        auto tickStart = Clock::now();
+        server.Tick();
+        longestTick = std::max(longestTick, Clock::now() - tickStart);
+
+        if (player && !player->CheckState(server))
+        {
+            divergedTick = tick + 1;
+            tickCount = tick + 1;
+            break;
+        }
+        if (hashInterval > 0 && (tick + 1) % hashInterval == 0)
+            stateHashes.push_back({(uint64_t)tick + 1, HashSimulationState(server)});
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    TelemetrySink::Stop();
+    Tracer::Stop();
+
+    const auto &pawns = server.GetPawns();
+    size_t alivePawns = std::ranges::count(pawns.alive, 1);
+
+    std::cout << std::format("seed: {}\n", seed)
+              << std::format("ticks: {}\n", tickCount)
+              << std::format("simulated_seconds: {:.2f}\n", tickCount * FIXED_DELTA_TIME)
+              << std::format("wall_seconds: {:.3f}\n", elapsed)
+              << std::format("ticks_per_second: {:.1f}\n", elapsed > 0. ? tickCount / elapsed : 0.)
+              << std::format("mean_tick_ms: {:.3f}\n", tickCount > 0 ? elapsed * 1000. / tickCount : 0.)
+              << std::format("max_tick_ms: {:.3f}\n", std::chrono::duration<double, std::milli>(longestTick).count())
+              << std::format("pawns: {} ({} alive)\n", pawns.Size(), alivePawns);
+    for (const auto &stateHash : stateHashes)
+        std::cout << std::format("state_hash: {} {:016x}\n", stateHash.tick, stateHash.hash);
+
+    if (divergedTick)
+    {
+        std::cout << std::format("diverged_at_tick: {}\n", *divergedTick);
+        return 2;
+    }
+    return 0;
+}
@@ -1,43 +1,46 @@
 #include "action.hpp"
 #include "astar.hpp"
 #include "component.hpp"
+#include "logger.hpp"
 #include "pawn.hpp"
+#include "pawn_table.hpp"
 #include "planned_task.hpp"
 #include "station.hpp"
 #include "tile.hpp"
 
-bool MoveAction::Update(const std::shared_ptr<Pawn> &pawn)
+bool MoveAction::Update(PawnStep &step)
 {
+    PawnTable &pawns = step.pawns;
+    const uint32_t slot = step.slot;
     isMoving = false;
 
-    if (!pawn)
-        return true;
-
-    auto currentTile = pawn->GetCurrentTile();
+    auto currentTile = pawns.floors[slot].lock();
     auto station = currentTile ? currentTile->GetStation() : nullptr;
     if (!station)
         return true;
 
-    if (path.empty())
+    Vector2 &position = pawns.positions[slot];
+    const auto &navGraph = station->navGraph;
+    if (HasPath() && navVersion != navGraph.version && !RepairPath(navGraph, position))
+        path.Get().clear();
+
+    if (!HasPath())
     {
-        path = FindPath(pawn->GetPosition(), targetPosition, station->navPolygons,
-                        [](const ConvexPolygon::Link &link)
-                        {
-                            if (auto doorTile = link.door.lock())
-                                return doorTile->IsActive(); // Only path through powered doors
-                            return true;
-                        });
-
-        if (path.empty())
+        // Unpowered doors are already marked blocked in the link state
+        nextWaypoint = 0;
+        navVersion = navGraph.version;
+        bool found = Pathfinder::ForCurrentThread().FindPath(navGraph, position, targetPosition, path.Get());
+
+        if (!found)
         {
-            TraceLog(LOG_INFO, "MoveAction: FindPath returned empty. Target: (%f, %f), Pos: (%f, %f)", targetPosition.x, targetPosition.y, pawn->GetPosition().x, pawn->GetPosition().y);
+            ASYNC_LOG(LOG_INFO, "MoveAction: FindPath returned empty. Target: ({}, {}), Pos: ({}, {})", targetPosition.x, targetPosition.y, position.x, position.y);
             return true;
         }
     }
 
     const float moveDelta = PAWN_MOVE_SPEED * FIXED_DELTA_TIME;
-    Vector2 nextWaypoint = path.front();
-    Vector2 dir = Vector2Normalize(nextWaypoint - pawn->GetPosition());
+    Vector2 waypoint = path[nextWaypoint];
+    Vector2 dir = Vector2Normalize(waypoint - position);
 
     // Update pawn facing direction based on movement direction
     // Determine the closest cardinal direction to the movement vector
@@ -54,16 +57,16 @@ bool MoveAction::Update(const std::shared_ptr<Pawn> &pawn)
             closestDir = cardinalDir;
         }
     }
-    pawn->SetFacingDirection(closestDir);
+    pawns.pawns[slot]->SetFacingDirection(closestDir);
 
     // Check for door at current position or slightly ahead
     std::shared_ptr<Tile> doorTile = nullptr;
-    Vector2Int currentTilePos = {(int)std::floor(pawn->GetPosition().x + .5f), (int)std::floor(pawn->GetPosition().y + .5f)};
+    Vector2Int currentTilePos = {(int)std::floor(position.x + .5f), (int)std::floor(position.y + .5f)};
     doorTile = station->GetTileWithComponentAtPosition(currentTilePos, ComponentType::DOOR);
 
     if (!doorTile)
     {
-        Vector2 checkPos = pawn->GetPosition() + dir * .6f;
+        Vector2 checkPos = position + dir * .6f;
         Vector2Int checkTilePos = {(int)std::floor(checkPos.x + .5f), (int)std::floor(checkPos.y + .5f)};
         doorTile = station->GetTileWithComponentAtPosition(checkTilePos, ComponentType::DOOR);
     }
@@ -72,49 +75,75 @@ bool MoveAction::Update(const std::shared_ptr<Pawn> &pawn)
     {
         if (auto door = doorTile->GetComponent<DoorComponent>())
         {
-            door->Open(1.f / PAWN_MOVE_SPEED);
+            bool isOpen = door->IsOpen();
+            step.Defer(OpenDoorWrite{std::move(door), 1.f / PAWN_MOVE_SPEED});
 
-            if (!door->IsOpen())
+            if (!isOpen)
                 return false; // Wait for the door to be fully open
         }
     }
 
-    float distToWaypoint = Vector2Distance(pawn->GetPosition(), nextWaypoint);
+    float distToWaypoint = Vector2Distance(position, waypoint);
 
     if (distToWaypoint <= moveDelta)
     {
         // Reach waypoint
         isMoving = distToWaypoint > 0.f;
-        pawn->SetPosition(nextWaypoint);
+        position = waypoint;
 
         // Reset door state if we just passed through one
-        Vector2Int currentTilePos = ToVector2Int(pawn->GetPosition());
+        Vector2Int currentTilePos = ToVector2Int(position);
         if (auto doorTile = station->GetTileWithComponentAtPosition(currentTilePos, ComponentType::DOOR))
         {
             if (auto door = doorTile->GetComponent<DoorComponent>())
-                door->Close();
+                step.Defer(CloseDoorWrite{std::move(door)});
         }
 
-        path.pop_front();
+        ++nextWaypoint;
 
-        if (path.empty())
+        if (!HasPath())
             return true;
     }
     else
     {
         // Move towards waypoint
         isMoving = true;
-        pawn->SetPosition(pawn->GetPosition() + Vector2Normalize(nextWaypoint - pawn->GetPosition()) * moveDelta);
+        position += Vector2Normalize(waypoint - position) * moveDelta;
     }
     return false;
 }
 
-bool ExtinguishAction::Update(const std::shared_ptr<Pawn> &pawn)
+bool MoveAction::RepairPath(const NavGraph &graph, const Vector2 &position)
 {
-    if (!pawn)
+    navVersion = graph.version;
+    auto &waypoints = path.Get();
+
+    // Everything after the last broken segment is still usable
+    size_t rejoinIdx = waypoints.size();
+    Vector2 from = position;
+    for (size_t i = nextWaypoint; i < waypoints.size(); ++i)
+    {
+        if (!graph.IsSegmentTraversable(from, waypoints[i]))
+            rejoinIdx = i;
+        from = waypoints[i];
+    }
+
+    if (rejoinIdx == waypoints.size())
         return true;
 
-    auto currentTile = pawn->GetCurrentTile();
+    thread_local std::vector<Vector2> repaired;
+    if (!Pathfinder::ForCurrentThread().FindPath(graph, position, waypoints[rejoinIdx], repaired))
+        return false;
+
+    repaired.insert(repaired.end(), waypoints.begin() + rejoinIdx + 1, waypoints.end());
+    waypoints.swap(repaired);
+    nextWaypoint = 0;
+    return true;
+}
+
+bool ExtinguishAction::Update(PawnStep &step)
+{
+    auto currentTile = step.pawns.floors[step.slot].lock();
     auto station = currentTile ? currentTile->GetStation() : nullptr;
     if (!station)
         return true;
@@ -123,7 +152,7 @@ bool ExtinguishAction::Update(const std::shared_ptr<Pawn> &pawn)
     {
         if (progress > 1.f)
         {
-            station->RemoveEffect(fire);
+            step.Defer(RemoveEffectWrite{std::move(fire)});
             return true;
         }
 
@@ -135,45 +164,87 @@ bool ExtinguishAction::Update(const std::shared_ptr<Pawn> &pawn)
     return false;
 }
 
-bool RepairAction::Update(const std::shared_ptr<Pawn> &pawn)
+bool RepairAction::Update(PawnStep &step)
 {
-    if (!pawn)
-        return true;
-
     auto targetTile = _targetTile.lock();
     auto durability = targetTile ? targetTile->GetComponent<DurabilityComponent>() : nullptr;
 
     if (!targetTile || !durability)
         return true;
 
-    const float maxHitpoints = durability->GetMaxHitpoints();
-    float newHitpoints = std::min(durability->GetHitpoints() + PAWN_REPAIR_SPEED * (float)FIXED_DELTA_TIME, maxHitpoints);
-
-    durability->SetHitpoints(newHitpoints);
+    const float repairAmount = PAWN_REPAIR_SPEED * (float)FIXED_DELTA_TIME;
+    bool isRepaired = durability->GetHitpoints() + repairAmount >= durability->GetMaxHitpoints();
+    step.Defer(RepairWrite{std::move(durability), repairAmount});
 
-    return newHitpoints >= maxHitpoints;
+    return isRepaired;
 }
 
-bool ConstructionAction::Update(const std::shared_ptr<Pawn> &pawn)
+ConstructionAction::~ConstructionAction()
 {
-    if (!pawn)
-        return true;
+    if (auto task = _task.lock())
+        JobBoard::Release(task, pawnId);
+}
 
+bool ConstructionAction::Update(PawnStep &step)
+{
     auto task = _task.lock();
     if (!task)
         return true;
 
-    auto currentTile = pawn->GetCurrentTile();
+    auto currentTile = step.pawns.floors[step.slot].lock();
     auto station = currentTile ? currentTile->GetStation() : nullptr;
     if (!station)
         return true;
 
-    task->progress += PAWN_BUILD_SPEED * FIXED_DELTA_TIME;
-
-    if (task->progress >= 1.f)
-    {
-        station->CompletePlannedTask(task->position);
+    // Give the task up if the pawn never made it next to it
+    if (Vector2IntChebyshev(ToVector2Int(step.pawns.positions[step.slot]), task->position) > 1)
         return true;
-    }
-    return false;
+
+    // Only the claimant builds the task, so its progress after the write is known here
+    const float buildAmount = PAWN_BUILD_SPEED * FIXED_DELTA_TIME;
+    bool isComplete = task->progress + buildAmount >= 1.f;
+    step.Defer(BuildWrite{std::move(task), buildAmount});
+    return isComplete;
+}
+
+bool ActionQueue::Push(Action &&action)
+{
+    if (IsFull())
+        return false;
+
+    actions[(head + count) % CAPACITY] = std::move(action);
+    ++count;
+    return true;
+}
+
+void ActionQueue::PopFront()
+{
+    if (IsEmpty())
+        return;
+
+    // Reset the slot so the finished action releases its claims and buffers now
+    actions[head] = Action();
+    head = (head + 1) % CAPACITY;
+    --count;
+}
+
+void ActionQueue::Clear()
+{
+    while (!IsEmpty())
+        PopFront();
+    head = 0;
+}
+
+bool UpdateAction(Action &action, PawnStep &step)
+{
+    return std::visit([&step](auto &concrete)
+                      { return concrete.Update(step); },
+                      action);
+}
+
+std::string GetActionName(const Action &action)
+{
+    return std::visit([](const auto &concrete)
+                      { return concrete.GetActionName(); },
+                      action);
 }
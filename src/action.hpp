@@ -1,44 +1,43 @@
 #pragma once
-#include "utils.hpp"
-#include <deque>
+#include "pawn_step.hpp"
+#include "waypoint_pool.hpp"
+#include <array>
+#include <variant>
 
-struct Pawn;
+struct NavGraph;
 struct Tile;
 struct PlannedTask;
 
-struct Action
-{
-    enum class Type : uint8_t
-    {
-        NONE,
-        MOVE,
-        EXTINGUISH,
-        REPAIR,
-        CONSTRUCTION,
-    };
-
-    virtual bool Update(const std::shared_ptr<Pawn> &pawn) = 0;
-    virtual std::string GetActionName() const = 0;
-    virtual Type GetType() const = 0;
-    virtual ~Action() = default;
-};
-
-struct MoveAction : Action
+struct MoveAction
 {
     Vector2 targetPosition;
-    std::deque<Vector2> path;
+    WaypointBuffer path;
+    size_t nextWaypoint = 0;
+    uint32_t navVersion = 0; // NavGraph version the path was last validated against
     bool isMoving = false;
 
+    MoveAction() = default;
     explicit MoveAction(const Vector2 &position) : targetPosition(position) {}
 
-    bool Update(const std::shared_ptr<Pawn> &pawn) override;
+    bool Update(PawnStep &step);
     bool IsMoving() const { return isMoving; }
-
-    std::string GetActionName() const override { return "Moving"; }
-    Type GetType() const override { return Type::MOVE; }
+    bool HasPath() const { return nextWaypoint < path.Size(); }
+    std::span<const Vector2> GetRemainingPath() const { return HasPath() ? path.View().subspan(nextWaypoint) : std::span<const Vector2>(); }
+
+    std::string GetActionName() const { return "Moving"; }
+
+private:
+    /**
+     * @brief Re-validates the remaining path after the graph changed.
+     * Broken sections are replaced by a local path from the pawn to the first waypoint
+     * after the last broken segment, keeping the rest of the route.
+     *
+     * @return false if the path could not be repaired and needs a full replan.
+     */
+    bool RepairPath(const NavGraph &graph, const Vector2 &position);
 };
 
-struct ExtinguishAction : Action
+struct ExtinguishAction
 {
 protected:
     Vector2Int targetPosition;
@@ -47,16 +46,15 @@ protected:
 public:
     explicit ExtinguishAction(const Vector2Int &position) : targetPosition(position), progress(0) {}
 
-    bool Update(const std::shared_ptr<Pawn> &pawn) override;
+    bool Update(PawnStep &step);
 
     float GetProgress() const { return progress; }
     const Vector2Int &GetTargetPosition() const { return targetPosition; }
 
-    std::string GetActionName() const override { return "Extinguishing"; }
-    Type GetType() const override { return Type::EXTINGUISH; }
+    std::string GetActionName() const { return "Extinguishing"; }
 };
 
-struct RepairAction : Action
+struct RepairAction
 {
 protected:
     std::weak_ptr<Tile> _targetTile;
@@ -64,26 +62,74 @@ protected:
 public:
     explicit RepairAction(std::shared_ptr<Tile> tile) : _targetTile(tile) {}
 
-    bool Update(const std::shared_ptr<Pawn> &pawn) override;
+    bool Update(PawnStep &step);
 
     std::shared_ptr<Tile> GetTargetTile() const { return _targetTile.lock(); }
 
-    std::string GetActionName() const override { return "Repairing"; }
-    Type GetType() const override { return Type::REPAIR; }
+    std::string GetActionName() const { return "Repairing"; }
 };
 
-struct ConstructionAction : Action
+struct ConstructionAction
 {
 protected:
     std::weak_ptr<PlannedTask> _task;
+    uint64_t pawnId; // Claimant of the task, the claim is released with the action
 
 public:
-    explicit ConstructionAction(std::shared_ptr<PlannedTask> task) : _task(task) {}
+    explicit ConstructionAction(std::shared_ptr<PlannedTask> task, uint64_t pawnId = 0) : _task(task), pawnId(pawnId) {}
+    ConstructionAction(const ConstructionAction &) = delete;
+    ConstructionAction &operator=(const ConstructionAction &) = delete;
+    ConstructionAction(ConstructionAction &&) = default;
+    ConstructionAction &operator=(ConstructionAction &&other) noexcept
+    {
+        std::swap(_task, other._task);
+        std::swap(pawnId, other.pawnId);
+        return *this;
+    }
+    ~ConstructionAction();
 
-    bool Update(const std::shared_ptr<Pawn> &pawn) override;
+    bool Update(PawnStep &step);
 
     std::weak_ptr<PlannedTask> GetPlanned() const { return _task; }
 
-    std::string GetActionName() const override { return "Constructing"; }
-    Type GetType() const override { return Type::CONSTRUCTION; }
-};
\ No newline at end of file
+    std::string GetActionName() const { return "Constructing"; }
+};
+
+using Action = std::variant<MoveAction, ExtinguishAction, RepairAction, ConstructionAction>;
+
+/**
+ * @brief Fixed-capacity ring buffer of a pawn's pending actions, stored inline.
+ */
+struct ActionQueue
+{
+    static constexpr size_t CAPACITY = 16;
+
+private:
+    std::array<Action, CAPACITY> actions;
+    uint8_t head = 0;
+    uint8_t count = 0;
+
+public:
+    bool IsEmpty() const { return count == 0; }
+    bool IsFull() const { return count == CAPACITY; }
+    size_t Size() const { return count; }
+
+    Action &Front() { return actions[head]; }
+    const Action &Front() const { return actions[head]; }
+    const Action &operator[](size_t index) const { return actions[(head + index) % CAPACITY]; }
+
+    /**
+     * @return false if the queue is full and the action was dropped.
+     */
+    bool Push(Action &&action);
+    void PopFront();
+    void Clear();
+};
+
+/**
+ * @brief Advances the action by one fixed tick. Safe to run for different pawns in parallel.
+ *
+ * @return true once the action is finished and should be removed.
+ */
+bool UpdateAction(Action &action, PawnStep &step);
+std::string GetActionName(const Action &action);
@@ -1,11 +1,156 @@
 #pragma once
 #include "navigation.hpp"
-#include <deque>
-#include <functional>
-
-std::deque<Vector2> FindPath(
-    const Vector2 &start, 
-    const Vector2 &end, 
-    const std::vector<ConvexPolygon> &polygons, 
-    std::function<bool(const ConvexPolygon::Link&)> isLinkTraversable = nullptr
-);
\ No newline at end of file
+#include <cstdint>
+
+/**
+ * @brief A* search over a NavGraph followed by funnel smoothing.
+ * Scratch buffers are owned by the pathfinder and reused between queries. Per-polygon
+ * state is invalidated by bumping a generation counter, so a query does not allocate
+ * once the buffers have grown to the size of the graph.
+ */
+class Pathfinder
+{
+public:
+    /**
+     * @brief Finds a path from start to end, writing the waypoints into outPath.
+     * Links marked blocked in the graph's link state are never taken.
+     *
+     * @param isLinkTraversable Callable taking a link index, returns false to skip the link.
+     * @return true if a path was found. outPath is left empty otherwise.
+     */
+    template <typename LinkFilter>
+    bool FindPath(const NavGraph &graph, const Vector2 &start, const Vector2 &end, LinkFilter &&isLinkTraversable, std::vector<Vector2> &outPath);
+
+    bool FindPath(const NavGraph &graph, const Vector2 &start, const Vector2 &end, std::vector<Vector2> &outPath)
+    {
+        return FindPath(graph, start, end, [](int)
+                        { return true; }, outPath);
+    }
+
+    /**
+     * @brief Computes the travel cost from start to end, including link costs, without building the path.
+     *
+     * @return true if end is reachable.
+     */
+    template <typename LinkFilter>
+    bool FindPathCost(const NavGraph &graph, const Vector2 &start, const Vector2 &end, LinkFilter &&isLinkTraversable, float &outCost);
+
+    bool FindPathCost(const NavGraph &graph, const Vector2 &start, const Vector2 &end, float &outCost)
+    {
+        return FindPathCost(graph, start, end, [](int)
+                            { return true; }, outCost);
+    }
+
+    static Pathfinder &ForCurrentThread()
+    {
+        thread_local static Pathfinder instance;
+        return instance;
+    }
+
+private:
+    struct OpenNode
+    {
+        int polyIdx;
+        float gCost, fCost;
+
+        static bool Greater(const OpenNode &a, const OpenNode &b) { return a.fCost > b.fCost; }
+    };
+
+    std::vector<uint32_t> visitGeneration;
+    std::vector<float> gCost;
+    std::vector<int> cameFromLink;
+    std::vector<OpenNode> openHeap;
+    std::vector<int> linkPath;
+    std::vector<std::pair<Vector2, Vector2>> portals;
+    uint32_t generation = 0;
+
+    template <typename LinkFilter>
+    bool Search(const NavGraph &graph, const Vector2 &start, const Vector2 &end, LinkFilter &&isLinkTraversable, int &startPoly, int &endPoly);
+
+    void BeginSearch(int polygonCount);
+    bool IsVisited(int polyIdx) const { return visitGeneration[polyIdx] == generation; }
+    void PushOpen(int polyIdx, float g, float f);
+    OpenNode PopOpen();
+    void BuildPath(const NavGraph &graph, int startPoly, int endPoly, const Vector2 &start, const Vector2 &end, std::vector<Vector2> &outPath);
+    void Funnel(const Vector2 &start, const Vector2 &end, std::vector<Vector2> &outPath);
+};
+
+template <typename LinkFilter>
+bool Pathfinder::FindPath(const NavGraph &graph, const Vector2 &start, const Vector2 &end, LinkFilter &&isLinkTraversable, std::vector<Vector2> &outPath)
+{
+    outPath.clear();
+
+    int startPoly, endPoly;
+    if (!Search(graph, start, end, isLinkTraversable, startPoly, endPoly))
+        return false;
+
+    if (startPoly == endPoly)
+        outPath.push_back(end);
+    else
+        BuildPath(graph, startPoly, endPoly, start, end, outPath);
+    return true;
+}
+
+template <typename LinkFilter>
+bool Pathfinder::FindPathCost(const NavGraph &graph, const Vector2 &start, const Vector2 &end, LinkFilter &&isLinkTraversable, float &outCost)
+{
+    int startPoly, endPoly;
+    if (!Search(graph, start, end, isLinkTraversable, startPoly, endPoly))
+        return false;
+
+    outCost = (startPoly == endPoly) ? Vector2Distance(start, end) : gCost[endPoly];
+    return true;
+}
+
+template <typename LinkFilter>
+bool Pathfinder::Search(const NavGraph &graph, const Vector2 &start, const Vector2 &end, LinkFilter &&isLinkTraversable, int &startPoly, int &endPoly)
+{
+    startPoly = graph.FindPolygonAt(start);
+    endPoly = graph.FindPolygonAt(end);
+    if (startPoly == -1 || endPoly == -1)
+        return false;
+    if (startPoly == endPoly)
+        return true;
+
+    BeginSearch(graph.GetPolygonCount());
+
+    visitGeneration[startPoly] = generation;
+    gCost[startPoly] = 0.f;
+    cameFromLink[startPoly] = -1;
+    PushOpen(startPoly, 0.f, Vector2Distance(start, end));
+
+    while (!openHeap.empty())
+    {
+        OpenNode cur = PopOpen();
+
+        if (cur.gCost > gCost[cur.polyIdx])
+            continue;
+        if (cur.polyIdx == endPoly)
+            break;
+
+        Vector2 fromPos = (cur.polyIdx == startPoly) ? start : graph.GetCenter(cur.polyIdx);
+
+        for (int linkIdx = graph.linkStart[cur.polyIdx]; linkIdx < graph.linkStart[cur.polyIdx + 1]; ++linkIdx)
+        {
+            const NavLinkState state = graph.linkState[linkIdx];
+            if (state.IsBlocked() || !isLinkTraversable(linkIdx))
+                continue;
+
+            int nbIdx = graph.linkTarget[linkIdx];
+            Vector2 nbCenter = graph.GetCenter(nbIdx);
+            float dist = Vector2Distance(fromPos, nbIdx == endPoly ? end : nbCenter) + state.cost;
+
+            float newG = cur.gCost + dist;
+            if (IsVisited(nbIdx) && newG >= gCost[nbIdx])
+                continue;
+
+            visitGeneration[nbIdx] = generation;
+            gCost[nbIdx] = newG;
+            cameFromLink[nbIdx] = linkIdx;
+            float h = (nbIdx == endPoly) ? 0.f : Vector2Distance(nbCenter, end);
+            PushOpen(nbIdx, newG, newG + h);
+        }
+    }
+
+    return IsVisited(endPoly);
+}
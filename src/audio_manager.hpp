@@ -1,4 +1,5 @@
 #pragma once
+#include "tracer.hpp"
 #include "utils.hpp"
 #include <opus/opusfile.h>
 #include <rtaudio/RtAudio.h>
@@ -91,6 +92,14 @@ private:
         if (status)
             throw std::runtime_error(std::format("Stream underflow detected: {}", status));
 
+        static thread_local bool isThreadNamed = false;
+        if (!isThreadNamed)
+        {
+            Tracer::SetThreadName("Audio");
+            isThreadNamed = true;
+        }
+        TraceZone zone("AudioCallback");
+
         float *output = static_cast<float *>(outputBuffer);
         AudioManager &audioManager = GetInstance();
 
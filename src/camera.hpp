@@ -9,6 +9,7 @@ struct PlayerCam
         OXYGEN,
         WALL,
         POWER,
+        PROFILER, // Tick and render timings
     };
 
     enum class DragType : uint8_t
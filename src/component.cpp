@@ -16,6 +16,35 @@ void OxygenProducerComponent::ProduceOxygen(float deltaTime) const
     oxygen->SetOxygenLevel(std::min(oxygen->GetOxygenLevel() + oxygenProduction * deltaTime, TILE_OXYGEN_MAX));
 }
 
+void PowerConsumerComponent::SetActive(bool active)
+{
+    if (isActive == active)
+        return;
+    isActive = active;
+
+    // Door traversability depends on power, keep the navigation state in sync
+    auto parent = GetParent();
+    if (parent && parent->GetStation() && parent->HasComponent(ComponentType::DOOR))
+        parent->GetStation()->UpdateDoorNavState(parent);
+}
+
+void DoorComponent::SyncNavState() const
+{
+    auto parent = GetParent();
+    if (parent && parent->GetStation())
+        parent->GetStation()->UpdateDoorNavState(parent);
+}
+
+void DoorComponent::SetLocked(bool newLocked)
+{
+    if (locked == newLocked)
+        return;
+    locked = newLocked;
+    if (locked)
+        forcedOpenTimer = 0.f;
+    SyncNavState();
+}
+
 void DoorComponent::Animate(float deltaTime)
 {
     if (forcedOpenTimer > 0.f)
@@ -51,7 +80,10 @@ void DoorComponent::Animate(float deltaTime)
         nextProgress = 0.f;
     }
 
+    bool wasOpen = IsOpen();
     SetProgress(nextProgress);
+    if (IsOpen() != wasOpen)
+        SyncNavState();
 }
 
 void DurabilityComponent::SetHitpoints(float newHitpoints)
@@ -123,7 +123,7 @@ public:
         : ComponentBase(parent), isActive(false), powerConsumption(std::max(powerConsumption, 0.f)), powerPriority(powerPriority) {}
 
     bool IsActive() const { return isActive; }
-    void SetActive(bool active) { isActive = active; }
+    void SetActive(bool active);
 
     float GetPowerConsumption() const { return powerConsumption; }
 
@@ -218,6 +218,9 @@ protected:
     float movingSpeed;
     float progress;
     float forcedOpenTimer = 0.f;
+    bool locked = false;
+
+    void SyncNavState() const;
 
 public:
     using ComponentBase::ComponentBase;
@@ -230,8 +233,13 @@ public:
     float GetProgress() const { return progress; }
     void SetProgress(float newProgress) { progress = std::clamp(newProgress, 0.f, 1.f); }
 
+    bool IsLocked() const { return locked; }
+    void SetLocked(bool newLocked);
+
     void Open(float duration)
     {
+        if (locked)
+            return;
         forcedOpenTimer = std::max(forcedOpenTimer, duration);
     }
 
@@ -243,7 +251,8 @@ public:
 
     std::optional<std::string> GetInfo() const override
     {
-        return std::string("   + State: ") + (IsOpen() ? "Open" : "Closed") + "(" + ToString(progress * 100.f, 0) + "%)";
+        return std::string("   + State: ") + (IsOpen() ? "Open" : "Closed") + "(" + ToString(progress * 100.f, 0) + "%)" +
+               (locked ? "\n   + Locked" : "");
     }
 };
 
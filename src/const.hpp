@@ -2,6 +2,7 @@
 #include <vector>
 #include <cstdint>
 #include <raylib.h>
+#include <string>
 
 inline double FIXED_DELTA_TIME;
 
@@ -38,3 +39,11 @@ inline float PAWN_EXTINGUISH_SPEED;
 inline float PAWN_REPAIR_SPEED;
 inline float PAWN_BUILD_SPEED;
 inline float PAWN_DECONSTRUCT_EFFICIENCY;
+
+inline int AI_DECISION_BUDGET;
+inline float AI_DECISION_INTERVAL;
+
+inline int SIM_LOD_INTERVAL;
+
+inline std::string TELEMETRY_PATH;
+inline int TELEMETRY_INTERVAL;
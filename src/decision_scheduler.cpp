@@ -0,0 +1,105 @@
+#include "decision_scheduler.hpp"
+
+// Max-heap ordering: highest priority first, then oldest
+static bool IsLessUrgent(const auto &a, const auto &b)
+{
+    if (a.priority != b.priority)
+        return a.priority < b.priority;
+    return a.sequence > b.sequence;
+}
+
+static DecisionPriority GetPriorityFor(PawnSituation situation, DecisionPriority fallback)
+{
+    return magic_enum::enum_flags_test_any(situation, PawnSituation::DANGER) ? DecisionPriority::DANGER : fallback;
+}
+
+void DecisionScheduler::Reset()
+{
+    pawnStates.clear();
+    pawnOrder.clear();
+    queue.clear();
+    sliceCursor = 0;
+    debt = 0;
+}
+
+void DecisionScheduler::RemovePawn(uint64_t pawnId)
+{
+    if (!pawnStates.erase(pawnId))
+        return;
+
+    auto it = std::ranges::find(pawnOrder, pawnId);
+    if (size_t index = it - pawnOrder.begin(); index < sliceCursor)
+        --sliceCursor;
+    pawnOrder.erase(it);
+}
+
+void DecisionScheduler::Enqueue(uint64_t pawnId, PawnState &state, DecisionPriority priority)
+{
+    if (state.isQueued && state.queuedPriority >= priority)
+        return;
+
+    state.isQueued = true;
+    state.queuedPriority = priority;
+    queue.push_back({priority, nextSequence++, pawnId});
+    std::push_heap(queue.begin(), queue.end(), IsLessUrgent<QueueEntry, QueueEntry>);
+}
+
+void DecisionScheduler::UpdateSituation(uint64_t pawnId, PawnSituation situation)
+{
+    auto [it, isNew] = pawnStates.try_emplace(pawnId);
+    if (isNew)
+        pawnOrder.push_back(pawnId);
+    else if (it->second.situation == situation)
+        return;
+
+    it->second.situation = situation;
+    Enqueue(pawnId, it->second, GetPriorityFor(situation, DecisionPriority::SITUATION_CHANGED));
+}
+
+void DecisionScheduler::BeginTick()
+{
+    spent = 0;
+    poppedThisTick = 0;
+
+    // Queue this tick's share of routine slices, so every pawn comes up once per interval
+    if (pawnOrder.empty())
+        return;
+    size_t sliceCount = (pawnOrder.size() + intervalTicks - 1) / intervalTicks;
+    for (size_t i = 0; i < sliceCount; ++i)
+    {
+        if (sliceCursor >= pawnOrder.size())
+            sliceCursor = 0;
+        uint64_t pawnId = pawnOrder[sliceCursor++];
+        auto &state = pawnStates.at(pawnId);
+        Enqueue(pawnId, state, GetPriorityFor(state.situation, DecisionPriority::ROUTINE));
+    }
+}
+
+bool DecisionScheduler::PopDue(uint64_t &outPawnId)
+{
+    while (!queue.empty())
+    {
+        if (poppedThisTick > 0 && spent + debt >= budget)
+            return false;
+
+        std::pop_heap(queue.begin(), queue.end(), IsLessUrgent<QueueEntry, QueueEntry>);
+        QueueEntry entry = queue.back();
+        queue.pop_back();
+
+        auto it = pawnStates.find(entry.pawnId);
+        if (it == pawnStates.end() || !it->second.isQueued || it->second.queuedPriority != entry.priority)
+            continue;
+
+        it->second.isQueued = false;
+        ++poppedThisTick;
+        spent += DECISION_COST;
+        outPawnId = entry.pawnId;
+        return true;
+    }
+    return false;
+}
+
+void DecisionScheduler::EndTick()
+{
+    debt = std::clamp(debt + spent - budget, 0, budget * MAX_DEBT_TICKS);
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include "utils.hpp"
+
+enum class PawnSituation : uint8_t
+{
+    NONE = 0,
+    IDLE = 1 << 0,
+    IN_FIRE = 1 << 1,
+    LOW_OXYGEN = 1 << 2,
+    LOW_HEALTH = 1 << 3,
+    DANGER = IN_FIRE | LOW_OXYGEN | LOW_HEALTH,
+};
+
+template <>
+struct magic_enum::customize::enum_range<PawnSituation>
+{
+    static constexpr bool is_flags = true;
+};
+
+enum class DecisionPriority : uint8_t
+{
+    ROUTINE,           // The pawn's regular slice came up
+    SITUATION_CHANGED, // Something about the pawn changed since it last decided
+    DANGER,            // The pawn is on fire, suffocating or badly hurt
+};
+
+/**
+ * @brief Spreads autonomous pawn decisions across fixed ticks under a work budget.
+ * Every pawn gets a routine slice once per decision interval, and is queued early when its
+ * situation changes. Queued pawns are handed out most urgent first until the tick's budget
+ * runs out, the rest wait for the next tick.
+ * The budget counts abstract work units rather than time, so which pawns decide on a tick
+ * does not depend on the machine and a replay makes the same decisions.
+ */
+class DecisionScheduler
+{
+public:
+    static constexpr float LOW_OXYGEN_FRACTION = .25f; // Of PAWN_OXYGEN_MAX
+    static constexpr float LOW_HEALTH_FRACTION = .5f;  // Of PAWN_HEALTH_MAX
+    static constexpr int MAX_DEBT_TICKS = 4;           // Overspent work carried over is capped at this many budgets
+    static constexpr int DECISION_COST = 1;            // Work units charged for each pawn handed out
+    static constexpr int PATH_QUERY_COST = 2;          // Work units charged for each path cost query
+
+    void SetBudget(int units) { budget = std::max(units, 1); }
+    int GetBudget() const { return budget; }
+    void SetInterval(int ticks) { intervalTicks = std::max(ticks, 1); }
+    size_t GetQueuedCount() const { return queue.size(); }
+
+    void Reset();
+    void RemovePawn(uint64_t pawnId);
+
+    /**
+     * @brief Records the pawn's current situation, queueing it for a decision if it changed.
+     * Registers pawns the scheduler has not seen yet.
+     */
+    void UpdateSituation(uint64_t pawnId, PawnSituation situation);
+
+    void BeginTick();
+
+    /**
+     * @brief Hands out the next pawn that should decide this tick.
+     * At least one pawn is handed out per tick, so the queue always drains.
+     *
+     * @return false once the queue is empty or the budget is spent.
+     */
+    bool PopDue(uint64_t &outPawnId);
+
+    /**
+     * @brief Charges work done for this tick's decisions on top of the per-decision cost.
+     * Negative units refund part of an earlier charge.
+     */
+    void Charge(int units) { spent += units; }
+
+    /**
+     * @brief Closes the tick, carrying any work spent over budget into the next one.
+     */
+    void EndTick();
+
+private:
+    struct PawnState
+    {
+        PawnSituation situation = PawnSituation::NONE;
+        bool isQueued = false;
+        DecisionPriority queuedPriority = DecisionPriority::ROUTINE;
+    };
+
+    struct QueueEntry
+    {
+        DecisionPriority priority;
+        uint64_t sequence; // Orders entries of equal priority first come, first served
+        uint64_t pawnId;
+    };
+
+    int budget = 1;
+    int debt = 0;
+    int spent = 0; // Work units charged this tick
+    int intervalTicks = 1;
+    int poppedThisTick = 0;
+
+    std::unordered_map<uint64_t, PawnState> pawnStates;
+    std::vector<uint64_t> pawnOrder; // Round-robin order of routine slices
+    size_t sliceCursor = 0;
+
+    std::vector<QueueEntry> queue; // Heap, entries superseded by a higher priority are skipped when popped
+    uint64_t nextSequence = 0;
+
+    void Enqueue(uint64_t pawnId, PawnState &state, DecisionPriority priority);
+};
@@ -210,6 +210,7 @@ namespace
 void DefinitionManager::ParseTilesFromFile(const std::string &filename)
 {
     std::vector<char> contents = ReadFromFile<std::vector<char>>(filename);
+    AddToDefinitionsHash(contents);
     ryml::Tree tree = ryml::parse_in_place(ryml::to_substr(contents));
 
     if (tree.empty())
@@ -326,6 +327,7 @@ void DefinitionManager::ParseTilesFromFile(const std::string &filename)
 void DefinitionManager::ParseEffectsFromFile(const std::string &filename)
 {
     std::vector<char> contents = ReadFromFile<std::vector<char>>(filename);
+    AddToDefinitionsHash(contents);
     ryml::Tree tree = ryml::parse_in_place(ryml::to_substr(contents));
 
     if (tree.empty())
@@ -370,6 +372,7 @@ void DefinitionManager::ParseEffectsFromFile(const std::string &filename)
 void DefinitionManager::ParseConstantsFromFile(const std::string &filename)
 {
     std::vector<char> contents = ReadFromFile<std::vector<char>>(filename);
+    AddToDefinitionsHash(contents);
     ryml::Tree tree = ryml::parse_in_place(ryml::to_substr(contents));
 
     if (tree.empty())
@@ -452,11 +455,29 @@ void DefinitionManager::ParseConstantsFromFile(const std::string &filename)
     PAWN_REPAIR_SPEED = GetRequiredValue<float>(root, "pawn/repairSpeed");
     PAWN_BUILD_SPEED = GetRequiredValue<float>(root, "pawn/buildSpeed");
     PAWN_DECONSTRUCT_EFFICIENCY = GetRequiredValue<float>(root, "pawn/deconstructEfficiency");
+
+    // ai (required)
+    AI_DECISION_BUDGET = GetRequiredValue<int>(root, "ai/decisionBudget");
+    AI_DECISION_INTERVAL = GetRequiredValue<float>(root, "ai/decisionInterval");
+
+    // lod (required)
+    SIM_LOD_INTERVAL = GetRequiredValue<int>(root, "lod/reducedInterval");
+
+    // telemetry (optional)
+    TELEMETRY_PATH.clear();
+    TELEMETRY_INTERVAL = 50;
+    if (root.has_child("telemetry"))
+    {
+        ryml::ConstNodeRef telemetryNode = root["telemetry"];
+        TELEMETRY_PATH = GetValue<std::string>(telemetryNode, "path", "");
+        TELEMETRY_INTERVAL = GetValue<int>(telemetryNode, "interval", TELEMETRY_INTERVAL);
+    }
 }
 
 void DefinitionManager::ParseResourcesFromFile(const std::string &filename)
 {
     std::vector<char> contents = ReadFromFile<std::vector<char>>(filename);
+    AddToDefinitionsHash(contents);
     ryml::Tree tree = ryml::parse_in_place(ryml::to_substr(contents));
 
     if (tree.empty())
@@ -482,6 +503,7 @@ void DefinitionManager::ParseResourcesFromFile(const std::string &filename)
 void DefinitionManager::ParsePawnsFromFile(const std::string &filename)
 {
     std::vector<char> contents = ReadFromFile<std::vector<char>>(filename);
+    AddToDefinitionsHash(contents);
     ryml::Tree tree = ryml::parse_in_place(ryml::to_substr(contents));
 
     if (tree.empty())
@@ -47,6 +47,7 @@ protected:
     std::unordered_map<std::string, std::shared_ptr<EffectDef>> effectDefinitions;
     std::unordered_map<std::string, std::shared_ptr<ResourceDef>> resourceDefinitions;
     std::unordered_map<std::string, std::shared_ptr<PawnDef>> pawnDefinitions;
+    uint64_t definitionsHash = FNV_OFFSET_BASIS;
 
     DefinitionManager() = default;
     ~DefinitionManager() = default;
@@ -59,6 +60,11 @@ protected:
         return instance;
     }
 
+    static void AddToDefinitionsHash(const std::vector<char> &contents)
+    {
+        GetInstance().definitionsHash = HashBytes(contents.data(), contents.size(), GetInstance().definitionsHash);
+    }
+
 public:
     static const std::unordered_map<std::string, std::shared_ptr<TileDef>> &GetTileDefinitions()
     {
@@ -165,4 +171,10 @@ public:
     static void ParseResourcesFromFile(const std::string &filename);
     static void ParseConstantsFromFile(const std::string &filename);
     static void ParsePawnsFromFile(const std::string &filename);
+
+    /**
+     * @brief Hash of every definition file parsed so far, in parse order.
+     * Replays compare it to tell whether they run against the definitions they were recorded with.
+     */
+    static uint64_t GetDefinitionsHash() { return GetInstance().definitionsHash; }
 };
@@ -1,8 +1,7 @@
 #include "component.hpp"
 #include "def_manager.hpp"
 #include "env_effect.hpp"
-#include "lua_bindings.hpp"
-#include "pawn.hpp"
+#include "pawn_table.hpp"
 #include "station.hpp"
 #include "tile.hpp"
 
@@ -29,9 +28,9 @@ std::string Effect::GetInfo() const
     return effectInfo;
 }
 
-void FireEffect::EffectPawn(const std::shared_ptr<Pawn> &pawn, float deltaTime) const
+void FireEffect::EffectPawn(PawnTable &pawns, uint32_t slot, float deltaTime) const
 {
-    pawn->SetHealth(pawn->GetHealth() - DAMAGE_PER_SECOND * deltaTime);
+    pawns.SetHealth(slot, pawns.health[slot] - DAMAGE_PER_SECOND * deltaTime);
 }
 
 void FireEffect::Update(const std::shared_ptr<Station> &station, size_t index)
@@ -67,7 +66,9 @@ void FireEffect::Update(const std::shared_ptr<Station> &station, size_t index)
     oxygen->SetOxygenLevel(oxygen->GetOxygenLevel() - oxygenToConsume);
     SetSize(GetSize() + (GROWTH_IF_FED_PER_SECOND * FIXED_DELTA_TIME));
 
-    if (!station->GetTileWithComponentAtPosition(GetPosition(), ComponentType::SOLID) && CheckIfEventHappens(SPREAD_CHANCE_PER_SECOND, FIXED_DELTA_TIME))
+    // Keyed by position, as at most one fire burns per position
+    auto random = station->GetRandomStream(RandomSystem::FIRE_SPREAD, GetPosition());
+    if (!station->GetTileWithComponentAtPosition(GetPosition(), ComponentType::SOLID) && random.CheckIfEventHappens(SPREAD_CHANCE_PER_SECOND, FIXED_DELTA_TIME))
     {
         std::vector<Vector2Int> possibleOffsets;
         for (const auto &dir : CARDINAL_DIRECTIONS)
@@ -81,7 +82,7 @@ void FireEffect::Update(const std::shared_ptr<Station> &station, size_t index)
         }
         if (!possibleOffsets.empty())
         {
-            int selected = RandomIntWithRange(0, static_cast<int>(possibleOffsets.size()) - 1);
+            int selected = random.NextInt(0, static_cast<int>(possibleOffsets.size()) - 1);
             station->effects.push_back(std::make_shared<FireEffect>(GetPosition() + possibleOffsets[selected]));
         }
     }
@@ -2,7 +2,7 @@
 #include "env_effect_def.hpp"
 #include <atomic>
 
-struct Pawn;
+struct PawnTable;
 struct Station;
 
 struct Effect
@@ -29,8 +29,10 @@ public:
 
     uint64_t GetInstanceId() const { return instanceId; }
     std::string GetInfo() const;
-    virtual void EffectPawn(const std::shared_ptr<Pawn> &pawn, float deltaTime) const = 0;
+    virtual void EffectPawn(PawnTable &pawns, uint32_t slot, float deltaTime) const = 0;
     virtual void Update(const std::shared_ptr<Station> &station, size_t index) = 0;
+    // Extra pathfinding cost for entering the area of this effect, in tiles
+    virtual float GetNavHazardCost() const { return 0.f; }
 
     float GetRoundedSize() const { return std::ceil(size * effectDef->GetSizeIncrements()) / (float)effectDef->GetSizeIncrements(); }
     const std::string &GetId() const { return effectDef->GetId(); }
@@ -43,11 +45,13 @@ struct FireEffect : Effect
     static constexpr float GROWTH_IF_FED_PER_SECOND = 1.f / 12.f;
     static constexpr float SPREAD_CHANCE_PER_SECOND = .2f;
     static constexpr float DAMAGE_PER_SECOND = 2.f;
+    static constexpr float NAV_HAZARD_COST = 20.f;
 
     explicit FireEffect(const Vector2Int &position, float size = 0) : Effect("FIRE", position, size) {}
 
-    void EffectPawn(const std::shared_ptr<Pawn> &pawn, float deltaTime) const override;
+    void EffectPawn(PawnTable &pawns, uint32_t slot, float deltaTime) const override;
     void Update(const std::shared_ptr<Station> &station, size_t index) override;
+    float GetNavHazardCost() const override { return NAV_HAZARD_COST * GetRoundedSize(); }
 
     float GetOxygenConsumption() const { return OXYGEN_CONSUMPTION_PER_SECOND * GetRoundedSize(); }
 };
@@ -56,6 +60,6 @@ struct FoamEffect : Effect
 {
     explicit FoamEffect(const Vector2Int &position, float size = 0) : Effect("FOAM", position, size) {}
 
-    void EffectPawn(const std::shared_ptr<Pawn> &, float) const override {}
+    void EffectPawn(PawnTable &, uint32_t, float) const override {}
     void Update(const std::shared_ptr<Station> &station, size_t index) override;
 };
\ No newline at end of file
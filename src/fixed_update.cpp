@@ -1,66 +1,41 @@
-#include "direction.hpp"
-#include "env_effect.hpp"
 #include "fixed_update.hpp"
 #include "game_server.hpp"
-#include "game_state.hpp"
-#include "pawn.hpp"
-#include "render_snapshot.hpp"
-#include "station.hpp"
-#include "tile.hpp"
-#include "update.hpp"
+#include "tracer.hpp"
 #include <chrono>
+#include <thread>
 
 std::mutex updateMutex;
 std::condition_variable fixedUpdateCondition;
 
-void FixedUpdate(double &timeSinceFixedUpdate)
+void FixedUpdate(GameServer &server, TickScheduler &scheduler)
 {
-    double previousTime = GetTime();
+    Tracer::SetThreadName("Simulation");
+    scheduler.Resync();
 
-    while (GameManager::IsInGameSim())
+    while (server.IsSimulationRunning())
     {
-        if (!GameManager::GetServer().IsGamePaused())
+        if (server.IsGamePaused())
         {
-            double currentTime = GetTime();
-            double deltaTime = currentTime - previousTime;
-            previousTime = currentTime;
-
-            timeSinceFixedUpdate += deltaTime;
-
-            while (timeSinceFixedUpdate >= FIXED_DELTA_TIME)
+            std::this_thread::sleep_for(std::chrono::duration<double>(FIXED_DELTA_TIME));
             {
                 std::unique_lock<std::mutex> lock(updateMutex);
-
-                GameManager::GetServer().ProcessPendingActions();
-                GameManager::GetServer().HandleAutonomousPawnDecisions();
-                HandlePawnActions();
-                HandlePawnEnvironment();
-                UpdatePawnCurrentTile();
-                UpdateEnvironmentalEffects();
-                UpdatePowerGrids();
-                UpdateTiles();
-
-                // Build and swap new RenderSnapshot for render thread
-                auto snapshot = std::make_shared<RenderSnapshot>();
-                snapshot->station = std::static_pointer_cast<const Station>(GameManager::GetServer().GetStation());
-                snapshot->pawnList.clear();
-                for (const auto &entry : GameManager::GetServer().GetPawnList())
-                    snapshot->pawnList[entry.first] = std::static_pointer_cast<const Pawn>(entry.second);
-                snapshot->timeSinceFixedUpdate = timeSinceFixedUpdate;
-                GameManager::SetRenderSnapshot(snapshot);
-
-                fixedUpdateCondition.notify_all();
-
-                timeSinceFixedUpdate -= FIXED_DELTA_TIME;
+                server.ApplyCommandsWhilePaused();
             }
+            scheduler.Resync();
+            continue;
         }
-        else
+
+        // A pause command takes effect inside Tick(), the rest of the batch must not run after it
+        int dueTicks = scheduler.WaitForTicks();
+        for (int tick = 0; tick < dueTicks && server.IsSimulationRunning() && !server.IsGamePaused(); ++tick)
         {
-            previousTime = GetTime();
+            std::unique_lock<std::mutex> lock(updateMutex, std::defer_lock);
+            {
+                TraceZone lockZone("WaitForUpdateLock");
+                lock.lock();
+            }
+            server.Tick();
+            fixedUpdateCondition.notify_all();
         }
-
-        std::this_thread::sleep_for(
-            std::chrono::milliseconds(
-                std::max(1, static_cast<int>(1000 * (FIXED_DELTA_TIME - timeSinceFixedUpdate)))));
     }
 }
@@ -1,8 +1,14 @@
 #pragma once
+#include "tick_scheduler.hpp"
 #include <condition_variable>
 #include <mutex>
 
+class GameServer;
+
 extern std::mutex updateMutex;
 extern std::condition_variable fixedUpdateCondition;
 
-void FixedUpdate(double &timeSinceFixedUpdate);
+/**
+ * @brief Runs the server's fixed ticks on the calling thread until the simulation is stopped.
+ */
+void FixedUpdate(GameServer &server, TickScheduler &scheduler);
@@ -1,13 +1,27 @@
 #include "action.hpp"
+#include "component.hpp"
+#include "def_manager.hpp"
 #include "direction.hpp"
 #include "fixed_update.hpp"
 #include "game_server.hpp"
+#include "logger.hpp"
 #include "pawn.hpp"
 #include "planned_task.hpp"
+#include "profiler.hpp"
+#include "replay.hpp"
+#include "sim_update.hpp"
 #include "station.hpp"
+#include "telemetry.hpp"
 #include "tile.hpp"
+#include "tracer.hpp"
+
+GameServer::GameServer()
+    : tickProfileSection(Profiler::AddSection("Tick", ProfileDomain::TICK)),
+      tickListenerProfileSection(Profiler::AddSection("TickListener", ProfileDomain::TICK_PHASE))
+{
+    BuildTickGraph();
+}
 
-GameServer::GameServer() = default;
 GameServer::~GameServer()
 {
     StopSimulation();
@@ -15,44 +29,35 @@ GameServer::~GameServer()
 
 void GameServer::Initialize()
 {
-    pawnList.clear();
+    pawns.Clear();
     station = nullptr;
     paused = false;
 
     isLocal = true;
-    {
-        std::lock_guard<std::mutex> lock(pendingActionsMutex);
-        pendingActions.clear();
-    }
-    timeSinceFixedUpdate = 0;
+    commands.Clear();
+    tickScheduler.Reset(FIXED_DELTA_TIME);
+    tickScheduler.SetTimeScale(TimeScale::NORMAL);
+
+    decisionScheduler.Reset();
+    decisionScheduler.SetBudget(AI_DECISION_BUDGET);
+    decisionScheduler.SetInterval((int)std::round(AI_DECISION_INTERVAL / FIXED_DELTA_TIME));
 }
 
 void GameServer::PrepareTestWorld()
 {
     station = CreateStation();
-    std::vector<std::shared_ptr<Pawn>> tmpPawnList = {
-        std::make_shared<Pawn>("ALICE", Vector2(-2, 2), RED),
-        std::make_shared<Pawn>("BOB", Vector2(3, 2), GREEN),
-        std::make_shared<Pawn>("CHARLIE", Vector2(-3, -3), ORANGE)};
-
-    pawnList.clear();
-    for (const auto &pawn : tmpPawnList)
-        pawnList[pawn->GetInstanceId()] = pawn;
+    station->seed = worldSeed;
+    pawns.Clear();
+    decisionScheduler.Reset();
+    pawns.Add(std::make_shared<Pawn>("ALICE", RED), Vector2(-2, 2));
+    pawns.Add(std::make_shared<Pawn>("BOB", GREEN), Vector2(3, 2));
+    pawns.Add(std::make_shared<Pawn>("CHARLIE", ORANGE), Vector2(-3, -3));
 
-    {
-        std::lock_guard<std::mutex> lock(pendingActionsMutex);
-        pendingActions.clear();
-    }
+    commands.Clear();
     paused = false;
 
     isLocal = true;
-    timeSinceFixedUpdate = 0;
-}
-
-std::shared_ptr<Pawn> GameServer::GetPawnById(uint64_t id) const
-{
-    auto it = pawnList.find(id);
-    return it != pawnList.end() ? it->second : nullptr;
+    tickScheduler.Reset(FIXED_DELTA_TIME);
 }
 
 void GameServer::StartSimulation()
@@ -60,66 +65,169 @@ void GameServer::StartSimulation()
     if (updateThread.joinable())
         return;
 
+    tickScheduler.Reset(FIXED_DELTA_TIME);
+    running = true;
     updateThread = std::thread([this]()
-                               { FixedUpdate(this->timeSinceFixedUpdate); });
+                               { FixedUpdate(*this, this->tickScheduler); });
 }
 
 void GameServer::StopSimulation()
 {
+    running = false;
     if (updateThread.joinable())
         updateThread.join();
 }
 
-void GameServer::SendPlayerAction(uint64_t pawnId, std::unique_ptr<Action> action)
+void GameServer::BuildTickGraph()
 {
-    std::lock_guard<std::mutex> lock(pendingActionsMutex);
-    pendingActions.emplace_back(pawnId, std::move(action));
+    using enum SimData;
+
+    // Declared in program order; sets must name everything a phase touches, or phases will race
+    tickGraph.AddPhase("Commands", PAWNS | TILES | DOORS, ACTIONS | TASKS | DOORS | NAV, [this]()
+                       { ApplyCommands(); });
+    tickGraph.AddPhase("Decisions", PAWNS | EFFECTS | TASKS | NAV, ACTIONS | DECISIONS | TASKS, [this]()
+                       { HandleAutonomousPawnDecisions(); });
+    tickGraph.AddPhase("PawnActions", ALL, PAWNS | ACTIONS | TASKS | TILES | DOORS | OXYGEN | POWER | NAV | EFFECTS, [this]()
+                       { HandlePawnActions(*this); });
+    tickGraph.AddPhase("PawnGrid", PAWNS, PAWN_GRID, [this]()
+                       { RebuildPawnGrid(); });
+
+    // Power only sees tiles and doors, so it runs next to the pawn phases below
+    tickGraph.AddPhase("Power", TILES | DOORS, POWER | NAV, [this]()
+                       { UpdatePowerGrids(*this); });
+    // Pawns killed by suffocation or effects drop their actions and release their job claims
+    tickGraph.AddPhase("PawnEnvironment", PAWNS | ACTIONS | PAWN_GRID | TILES | EFFECTS, PAWNS | ACTIONS | TASKS | OXYGEN | DECISIONS, [this]()
+                       { HandlePawnEnvironment(*this); });
+    tickGraph.AddPhase("PawnCurrentTile", PAWNS | TILES, PAWNS, [this]()
+                       { UpdatePawnCurrentTile(*this); });
+
+    // Effects can destroy tiles, which touches nearly everything
+    tickGraph.AddPhase("Effects", TILES | DOORS | OXYGEN | EFFECTS, TILES | DOORS | OXYGEN | POWER | NAV | EFFECTS, [this]()
+                       { UpdateEnvironmentalEffects(*this); });
+    tickGraph.AddPhase("Doors", TILES | DOORS | POWER, DOORS | NAV, [this]()
+                       { AnimateDoors(*this); });
+    tickGraph.AddPhase("Oxygen", TILES | DOORS | POWER | OXYGEN, OXYGEN, [this]()
+                       { UpdateOxygen(*this); });
 }
 
-void GameServer::ClearPawnActions(uint64_t pawnId)
+void GameServer::Tick()
 {
-    // Lock updateMutex first, then pendingActionsMutex to match ProcessPendingActions lock order
-    std::unique_lock<std::mutex> lock(updateMutex);
+    ScopedTimer timer(tickProfileSection);
+    tickGraph.Run();
+    if (station)
     {
-        std::lock_guard<std::mutex> pendingLock(pendingActionsMutex);
-        // Remove any pending actions for this pawn so they don't get re-applied on next fixed update
-        pendingActions.erase(
-            std::remove_if(pendingActions.begin(), pendingActions.end(),
-                           [pawnId](const std::pair<uint64_t, std::unique_ptr<Action>> &p)
-                           { return p.first == pawnId; }),
-            pendingActions.end());
+        ++station->tick;
+        if (recording && recording->hashInterval > 0 && station->tick % recording->hashInterval == 0)
+            recording->stateHashes.push_back({station->tick, HashSimulationState(*this)});
     }
 
-    if (auto _pawn = Find(pawnList, pawnId))
-        if (auto pawn = _pawn.value()->second)
-            pawn->GetActionQueue().clear();
+    if (tickListener)
+    {
+        ScopedTimer listenerTimer(tickListenerProfileSection);
+        tickListener(*this);
+    }
+
+    TelemetrySink::OnTick(*this);
 }
 
-void GameServer::ProcessPendingActions()
+void GameServer::ApplyCommandsWhilePaused()
 {
-    std::deque<std::pair<uint64_t, std::unique_ptr<Action>>> actionsToProcess;
+    if (ApplyCommands() > 0 && tickListener)
+        tickListener(*this);
+}
+
+void GameServer::SendCommand(PlayerCommand &&command)
+{
+    if (!commands.TryPush(std::move(command)))
+        ASYNC_LOG(LOG_WARNING, "Dropping player command, the command queue is full");
+}
+
+size_t GameServer::ApplyCommands()
+{
+    size_t applied = 0;
+    PlayerCommand command;
+    while (commands.TryPop(command))
     {
-        std::lock_guard<std::mutex> lock(pendingActionsMutex);
-        actionsToProcess.swap(pendingActions);
+        if (recording)
+            recording->commands.push_back({station ? station->tick : 0, command});
+        ApplyCommand(command);
+        ++applied;
     }
+    Tracer::RecordCounter("Commands", (double)applied);
+    return applied;
+}
+
+void GameServer::StartRecording(int hashInterval)
+{
+    if (station && station->tick > 0)
+        throw std::runtime_error(std::format("Cannot start recording at tick {}, replays start from a fresh world", station->tick));
+
+    recording = std::make_unique<Replay>();
+    recording->seed = worldSeed;
+    recording->definitionsHash = DefinitionManager::GetDefinitionsHash();
+    recording->hashInterval = std::max(hashInterval, 0);
+    recording->pawnIds = pawns.ids;
+}
 
-    for (auto &entry : actionsToProcess)
+std::unique_ptr<Replay> GameServer::StopRecording()
+{
+    if (recording)
+        recording->tickCount = station ? station->tick : 0;
+    return std::move(recording);
+}
+
+void GameServer::ApplyCommand(PlayerCommand &command)
+{
+    if (auto move = std::get_if<MovePawnCommand>(&command))
     {
-        if (auto pawn = GetPawnById(entry.first))
-        {
-            if (!pawn->IsAlive())
-            {
-                TraceLog(TraceLogLevel::LOG_WARNING, std::format("Dropping action for dead pawn {}", pawn->GetName()).c_str());
-                continue;
-            }
-            if (!pawn->GetCurrentTile())
-            {
-                TraceLog(TraceLogLevel::LOG_WARNING, std::format("Dropping action for pawn {} with no current tile", pawn->GetName()).c_str());
-                continue;
-            }
+        auto slot = pawns.GetSlot(move->pawnId);
+        if (!slot)
+            return;
 
-            pawn->GetActionQueue().push_back(std::move(entry.second));
+        const auto &pawn = pawns.pawns[*slot];
+        if (!pawns.alive[*slot])
+        {
+            ASYNC_LOG(LOG_WARNING, "Dropping action for dead pawn {}", pawn->GetName());
+            return;
+        }
+        if (pawns.floors[*slot].expired())
+        {
+            ASYNC_LOG(LOG_WARNING, "Dropping action for pawn {} with no current tile", pawn->GetName());
+            return;
         }
+
+        if (!pawn->GetActionQueue().Push(MoveAction(move->targetPosition)))
+            ASYNC_LOG(LOG_WARNING, "Dropping action for pawn {} with a full action queue", pawn->GetName());
+    }
+    else if (auto clear = std::get_if<ClearPawnActionsCommand>(&command))
+    {
+        if (auto slot = pawns.GetSlot(clear->pawnId))
+            pawns.pawns[*slot]->GetActionQueue().Clear();
+    }
+    else if (auto plan = std::get_if<PlanTaskCommand>(&command))
+    {
+        if (station)
+            station->AddPlannedTask(plan->position, plan->tileId, plan->isBuild, plan->rotation);
+    }
+    else if (auto cancel = std::get_if<CancelTaskCommand>(&command))
+    {
+        if (station && station->HasPlannedTaskAt(cancel->position))
+            station->CancelPlannedTask(cancel->position);
+    }
+    else if (auto lock = std::get_if<ToggleDoorLockCommand>(&command))
+    {
+        if (!station)
+            return;
+        auto doorTile = station->GetTileWithComponentAtPosition(lock->position, ComponentType::DOOR);
+        if (!doorTile)
+            return;
+        auto door = doorTile->GetComponent<DoorComponent>();
+        door->SetLocked(!door->IsLocked());
+    }
+    else if (auto pause = std::get_if<PauseCommand>(&command))
+    {
+        if (isLocal.load())
+            paused.store(pause->paused.value_or(!paused.load()));
     }
 }
 
@@ -128,57 +236,93 @@ void GameServer::HandleAutonomousPawnDecisions()
     if (!station)
         return;
 
-    for (const auto &entry : pawnList)
+    // Only pawns handed out by the scheduler decide this tick, most urgent first
+    decisionScheduler.BeginTick();
+    idlePawns.clear();
+    const int assignmentReserve = station->jobBoard.GetJobCount() > 0 ? JobBoard::CANDIDATES_PER_PAWN * DecisionScheduler::PATH_QUERY_COST : 0;
+    uint64_t pawnId;
+    while (decisionScheduler.PopDue(pawnId))
     {
-        const auto &pawn = entry.second;
-        if (!pawn->IsAlive() || !pawn->GetActionQueue().empty() || !pawn->GetCurrentTile())
+        auto slot = pawns.GetSlot(pawnId);
+        if (!slot || !pawns.alive[*slot])
+        {
+            decisionScheduler.RemovePawn(pawnId);
+            continue;
+        }
+
+        const auto &pawn = pawns.pawns[*slot];
+        auto currentTile = pawns.floors[*slot].lock();
+        if (!pawn->GetActionQueue().IsEmpty() || !currentTile)
             continue;
 
-        auto stationPtr = pawn->GetCurrentTile()->GetStation();
+        auto stationPtr = currentTile->GetStation();
         if (!stationPtr)
             continue;
-        Vector2Int pawnPos = ToVector2Int(pawn->GetPosition());
+        Vector2Int pawnPos = ToVector2Int(pawns.positions[*slot]);
 
         if (stationPtr->GetEffectOfTypeAtPosition(pawnPos, "FIRE"))
         {
-            pawn->GetActionQueue().push_back(std::make_shared<ExtinguishAction>(pawnPos));
+            pawn->GetActionQueue().Push(ExtinguishAction(pawnPos));
             continue;
         }
 
+        bool fightingFire = false;
         for (const auto &direction : ALL_DIRECTIONS)
         {
             Vector2Int neighborPos = pawnPos + DirectionToVector2Int(direction);
             if (stationPtr->GetEffectOfTypeAtPosition(neighborPos, "FIRE"))
             {
-                pawn->GetActionQueue().push_back(std::make_shared<ExtinguishAction>(neighborPos));
+                pawn->GetActionQueue().Push(ExtinguishAction(neighborPos));
+                fightingFire = true;
                 break;
             }
         }
 
-        for (const auto &task : stationPtr->plannedTasks)
+        if (!fightingFire)
         {
-            if (Vector2IntChebyshev(pawnPos, task->position) <= 1)
-            {
-                pawn->GetActionQueue().push_back(std::make_shared<ConstructionAction>(task));
-                break;
-            }
+            // Reserve the most path queries job assignment can run for this pawn, so the budget
+            // stops handing out pawns before assignment could overrun it
+            idlePawns.emplace_back(pawnId, pawns.positions[*slot]);
+            decisionScheduler.Charge(assignmentReserve);
         }
     }
+
+    // Hand out planned tasks to the remaining idle pawns in one batch, then charge what it actually ran
+    int pathQueries = station->jobBoard.AssignJobs(*station, idlePawns, jobAssignments);
+    decisionScheduler.Charge(pathQueries * DecisionScheduler::PATH_QUERY_COST - (int)idlePawns.size() * assignmentReserve);
+    for (const auto &assignment : jobAssignments)
+    {
+        uint32_t slot = *pawns.GetSlot(assignment.pawnId);
+        auto &actionQueue = pawns.pawns[slot]->GetActionQueue();
+        if (Vector2IntChebyshev(ToVector2Int(pawns.positions[slot]), assignment.task->position) != 1)
+            actionQueue.Push(MoveAction(assignment.workPosition));
+        actionQueue.Push(ConstructionAction(assignment.task, assignment.pawnId));
+    }
+
+    decisionScheduler.EndTick();
 }
 
 void GameServer::RequestPlannedTask(const Vector2Int &pos, const std::string &tileId, bool place, Rotation rotation)
 {
-    std::unique_lock<std::mutex> lock(updateMutex);
-    if (!station)
-        return;
-    station->AddPlannedTask(pos, tileId, place, rotation);
+    SendCommand(PlanTaskCommand{pos, tileId, place, rotation});
 }
 
 void GameServer::RequestCancelPlannedTask(const Vector2Int &pos)
 {
-    std::unique_lock<std::mutex> lock(updateMutex);
-    if (!station)
-        return;
-    if (station->HasPlannedTaskAt(pos))
-        station->CancelPlannedTask(pos);
+    SendCommand(CancelTaskCommand{pos});
+}
+
+void GameServer::RequestToggleDoorLock(const Vector2Int &pos)
+{
+    SendCommand(ToggleDoorLockCommand{pos});
+}
+
+void GameServer::RequestPawnMove(uint64_t pawnId, const Vector2 &targetPosition)
+{
+    SendCommand(MovePawnCommand{pawnId, targetPosition});
+}
+
+void GameServer::ClearPawnActions(uint64_t pawnId)
+{
+    SendCommand(ClearPawnActionsCommand{pawnId});
 }
@@ -1,12 +1,18 @@
 #pragma once
+#include "decision_scheduler.hpp"
 #include "direction.hpp"
+#include "job_board.hpp"
+#include "pawn_grid.hpp"
+#include "pawn_table.hpp"
+#include "player_command.hpp"
+#include "sim_update.hpp"
+#include "tick_graph.hpp"
+#include "tick_scheduler.hpp"
 #include "utils.hpp"
-#include <deque>
-#include <mutex>
+#include <functional>
 #include <thread>
 
-struct Action;
-struct Pawn;
+struct Replay;
 struct Station;
 
 class GameServer
@@ -20,43 +26,117 @@ public:
     void PrepareTestWorld();
     void StartSimulation();
     void StopSimulation();
+    bool IsSimulationRunning() const { return running.load(); }
+
+    /**
+     * @brief Runs every phase of one fixed tick, then calls the tick listener.
+     * Phases run on the worker pool, concurrently where their data does not overlap.
+     * The caller must hold updateMutex if the simulation thread is running.
+     */
+    void Tick();
+
+    /**
+     * @brief Sets a callback run after every tick and after commands applied while paused,
+     * on the simulation thread with updateMutex held.
+     */
+    void SetTickListener(std::function<void(const GameServer &)> listener) { tickListener = std::move(listener); }
 
     // Simulation getters
-    const std::unordered_map<uint64_t, std::shared_ptr<Pawn>> &GetPawnList() const { return pawnList; }
+    const PawnTable &GetPawns() const { return pawns; }
+    PawnTable &GetPawns() { return pawns; }
+    const PawnGrid &GetPawnGrid() const { return pawnGrid; }
+    void RebuildPawnGrid() { pawnGrid.Rebuild(pawns.positions); }
     std::shared_ptr<Station> GetStation() const { return station; }
     bool IsGamePaused() const { return paused.load(); }
+    uint64_t GetWorldSeed() const { return worldSeed; }
+    void SetWorldSeed(uint64_t seed) { worldSeed = seed; } // Used by the next world prepared
+    DecisionScheduler &GetDecisionScheduler() { return decisionScheduler; }
+    SimScratch &GetSimScratch() { return simScratch; }
 
+    // Player commands, queued without blocking and applied by the simulation at the start of the next tick
     void RequestPlannedTask(const Vector2Int &pos, const std::string &tileId, bool place, Rotation rotation = Rotation::UP);
     void RequestCancelPlannedTask(const Vector2Int &pos);
-    void SetGamePaused(bool newState)
-    {
-        if (isLocal.load())
-            paused.store(newState);
-    }
-    void ToggleGamePaused()
+    void RequestToggleDoorLock(const Vector2Int &pos);
+    void RequestPawnMove(uint64_t pawnId, const Vector2 &targetPosition);
+    void ClearPawnActions(uint64_t pawnId);
+    void SetGamePaused(bool newState) { SendCommand(PauseCommand{newState}); }
+    void ToggleGamePaused() { SendCommand(PauseCommand{}); }
+
+    /**
+     * @brief Queues any command, for callers replaying commands rather than sending them for a player.
+     *
+     * @return false if the queue is full and the command was not taken.
+     */
+    bool TrySendCommand(PlayerCommand &&command) { return commands.TryPush(std::move(command)); }
+
+    TimeScale GetTimeScale() const { return tickScheduler.GetTimeScale(); }
+    void SetTimeScale(TimeScale scale)
     {
         if (isLocal.load())
-            paused.store(!paused.load());
+            tickScheduler.SetTimeScale(scale);
     }
     bool IsLocal() const { return isLocal.load(); }
-    void SendPlayerAction(uint64_t pawnId, std::unique_ptr<Action> action);
-    void ClearPawnActions(uint64_t pawnId);
     void HandleAutonomousPawnDecisions();
-    void ProcessPendingActions();
 
-    double &GetTimeSinceFixedUpdate() { return timeSinceFixedUpdate; }
+    /**
+     * @brief Applies every queued player command in the order it was sent.
+     *
+     * @return The number of commands applied.
+     */
+    size_t ApplyCommands();
+
+    /**
+     * @brief Applies queued commands without ticking, so a paused game still resumes and takes plans.
+     * The caller must hold updateMutex if the simulation thread is running.
+     */
+    void ApplyCommandsWhilePaused();
+
+    /**
+     * @brief Starts recording every applied command, to be replayed from a fresh world.
+     * Call right after the world is prepared. Throws if the station has already ticked.
+     *
+     * @param hashInterval Ticks between recorded state hashes, 0 for none.
+     */
+    void StartRecording(int hashInterval);
+
+    /**
+     * @brief Ends the recording. The caller must hold updateMutex if the simulation thread is running.
+     *
+     * @return The recorded session, nullptr if nothing was being recorded.
+     */
+    std::unique_ptr<Replay> StopRecording();
+    bool IsRecording() const { return recording != nullptr; }
+
+    const TickScheduler &GetTickScheduler() const { return tickScheduler; }
+    const TickGraph &GetTickGraph() const { return tickGraph; }
 
 private:
-    std::unordered_map<uint64_t, std::shared_ptr<Pawn>> pawnList;
+    PawnTable pawns;
+    PawnGrid pawnGrid;
     std::shared_ptr<Station> station;
+    uint64_t worldSeed = 0;
 
     std::atomic<bool> paused = false;
     std::atomic<bool> isLocal = true;
-    double timeSinceFixedUpdate = 0;
+    std::atomic<bool> running = false;
+    TickScheduler tickScheduler;
+    TickGraph tickGraph;
 
     std::thread updateThread;
-    std::deque<std::pair<uint64_t, std::unique_ptr<Action>>> pendingActions;
-    std::mutex pendingActionsMutex;
+    std::function<void(const GameServer &)> tickListener;
+    CommandRing commands;
+    std::unique_ptr<Replay> recording;
+    size_t tickProfileSection;
+    size_t tickListenerProfileSection;
+
+    DecisionScheduler decisionScheduler;
+    SimScratch simScratch;
+
+    // Scratch buffers for autonomous job assignment
+    std::vector<std::pair<uint64_t, Vector2>> idlePawns;
+    std::vector<JobBoard::Assignment> jobAssignments;
 
-    std::shared_ptr<Pawn> GetPawnById(uint64_t id) const;
+    void BuildTickGraph();
+    void SendCommand(PlayerCommand &&command);
+    void ApplyCommand(PlayerCommand &command);
 };
@@ -2,10 +2,45 @@
 #include "game_server.hpp"
 #include "game_state.hpp"
 #include "render_snapshot.hpp"
+#include "replay.hpp"
+#include "station.hpp"
+#include "telemetry.hpp"
+#include "tracer.hpp"
 #include "ui_manager.hpp"
 #include "ui.hpp"
+#include <filesystem>
 #include <sol/sol.hpp>
 
+static std::unique_ptr<GameServer> CreateServer()
+{
+    auto server = std::make_unique<GameServer>();
+    server->SetTickListener(GameManager::PublishRenderSnapshot);
+    return server;
+}
+
+/**
+ * Saves the commands recorded by the server, if it was recording.
+ * The world seed goes into the file name, so each game keeps its own recording.
+ */
+static void SaveRecording(GameServer &server, const std::string &basePath)
+{
+    auto replay = server.StopRecording();
+    if (!replay)
+        return;
+
+    std::filesystem::path path = basePath;
+    path.replace_filename(std::format("{}-{}{}", path.stem().string(), replay->seed, path.extension().string()));
+    try
+    {
+        replay->Save(path.string());
+        TraceLog(TraceLogLevel::LOG_INFO, std::format("Saved {} commands over {} ticks to {}", replay->commands.size(), replay->tickCount, path.string()).c_str());
+    }
+    catch (const std::exception &e)
+    {
+        TraceLog(TraceLogLevel::LOG_ERROR, e.what());
+    }
+}
+
 void GameManager::SetGameState(GameState state)
 {
     auto &manager = GetInstance();
@@ -17,11 +52,11 @@ void GameManager::SetGameState(GameState state)
     if (state != GameState::GAME_SIM && manager.server)
     {
         manager.server->StopSimulation();
-        manager.server->GetTimeSinceFixedUpdate() = 0;
+        SaveRecording(*manager.server, manager.recordingPath);
     }
 
     UiManager::ClearAllElements();
-    GameManager::SetRenderSnapshot(nullptr);
+    GameManager::ResetRenderSnapshots();
     ClearRenderSystems();
     ClearStarfield();
 
@@ -39,10 +74,7 @@ void GameManager::SetGameState(GameState state)
         PrepareTestWorld();
         UiManager::InitializeGameSim();
         if (manager.server)
-        {
-            manager.server->GetTimeSinceFixedUpdate() = 0;
             manager.server->StartSimulation();
-        }
         break;
     }
     default:
@@ -50,6 +82,24 @@ void GameManager::SetGameState(GameState state)
     }
 }
 
+/**
+ * Starts a trace capture, or ends the running one and writes it out.
+ */
+static void ToggleTracing()
+{
+    try
+    {
+        if (Tracer::IsRecording())
+            Tracer::Stop();
+        else
+            Tracer::Start(Tracer::GetPath().empty() ? "celestium_trace.json" : Tracer::GetPath());
+    }
+    catch (const std::exception &e)
+    {
+        TraceLog(TraceLogLevel::LOG_ERROR, e.what());
+    }
+}
+
 /**
  * Toggles camera state based on user key input.
  */
@@ -57,6 +107,9 @@ void GameManager::HandleStateInputs()
 {
     auto &camera = GetCamera();
 
+    if (IsKeyPressed(KEY_F9))
+        ToggleTracing();
+
     if (IsKeyPressed(KEY_ESCAPE))
     {
         if (IsInGameSim())
@@ -70,6 +123,18 @@ void GameManager::HandleStateInputs()
         if (IsKeyPressed(KEY_SPACE))
             GameManager::GetServer().ToggleGamePaused();
 
+        if (IsKeyPressed(KEY_ONE))
+            GameManager::GetServer().SetTimeScale(TimeScale::NORMAL);
+
+        if (IsKeyPressed(KEY_TWO))
+            GameManager::GetServer().SetTimeScale(TimeScale::DOUBLE);
+
+        if (IsKeyPressed(KEY_THREE))
+            GameManager::GetServer().SetTimeScale(TimeScale::QUADRUPLE);
+
+        if (IsKeyPressed(KEY_FOUR))
+            GameManager::GetServer().SetTimeScale(TimeScale::MAX);
+
         if (IsKeyPressed(KEY_O))
             camera.ToggleOverlay(PlayerCam::Overlay::OXYGEN);
 
@@ -79,6 +144,9 @@ void GameManager::HandleStateInputs()
         if (IsKeyPressed(KEY_P))
             camera.ToggleOverlay(PlayerCam::Overlay::POWER);
 
+        if (IsKeyPressed(KEY_T))
+            camera.ToggleOverlay(PlayerCam::Overlay::PROFILER);
+
         if (IsKeyPressed(KEY_B))
             GameManager::ToggleBuildGameState();
     }
@@ -92,7 +160,7 @@ void GameManager::Initialize()
     manager.camera = std::make_unique<PlayerCam>();
     manager.camera->SetFpsIndex(currentFpsIndex);
 
-    manager.server = std::make_unique<GameServer>();
+    manager.server = CreateServer();
     manager.server->Initialize();
 }
 
@@ -126,8 +194,15 @@ void GameManager::PrepareTestWorld()
     manager.camera->SetFpsIndex(currentFpsIndex);
 
     if (!manager.server)
-        manager.server = std::make_unique<GameServer>();
+        manager.server = CreateServer();
+
+    // Logged so a session can be reproduced by seeding the headless runner the same way
+    uint64_t seed = (uint64_t)std::random_device()() << 32 | std::random_device()();
+    TraceLog(TraceLogLevel::LOG_INFO, std::format("World seed: {}", seed).c_str());
+    manager.server->SetWorldSeed(seed);
     manager.server->PrepareTestWorld();
+    if (!manager.recordingPath.empty())
+        manager.server->StartRecording(Replay::DEFAULT_HASH_INTERVAL);
 }
 
 void GameManager::ToggleSelectedPawn(uint64_t pawnId)
@@ -229,7 +304,7 @@ GameServer &GameManager::GetServer()
 {
     auto &instance = GetInstance();
     if (!instance.server)
-        instance.server = std::make_unique<GameServer>();
+        instance.server = CreateServer();
     return *instance.server;
 }
 
@@ -242,14 +317,35 @@ PlayerCam &GameManager::GetCamera()
 }
 
 
-std::shared_ptr<RenderSnapshot> GameManager::GetRenderSnapshot()
+const RenderSnapshot *GameManager::GetRenderSnapshot()
+{
+    return GetInstance().renderSnapshots->GetFront();
+}
+
+void GameManager::AcquireRenderSnapshot()
+{
+    GetInstance().renderSnapshots->Acquire();
+}
+
+/**
+ * Hands the state of every finished tick to the render thread.
+ */
+void GameManager::PublishRenderSnapshot(const GameServer &server)
 {
-    return GetInstance().renderSnapshot.load(std::memory_order_acquire);
+    auto &instance = GetInstance();
+    auto &buffer = *instance.renderSnapshots;
+    auto &snapshot = buffer.GetBack();
+    snapshot.Capture(server, instance.inspectedTile.load(std::memory_order_relaxed), buffer.GetLastPublished());
+    if (TelemetrySink::IsRunning())
+        TelemetrySink::SetGauge("snapshot_bytes", (double)snapshot.GetMemoryUsage());
+    if (Tracer::IsRecording())
+        Tracer::RecordCounter("SnapshotBytes", (double)snapshot.GetMemoryUsage());
+    buffer.Publish();
 }
 
-void GameManager::SetRenderSnapshot(std::shared_ptr<RenderSnapshot> snap)
+void GameManager::ResetRenderSnapshots()
 {
-    GetInstance().renderSnapshot.store(std::move(snap), std::memory_order_release);
+    GetInstance().renderSnapshots->Reset();
 }
 
 void GameManager::ApplyPendingState()
@@ -262,5 +358,5 @@ void GameManager::ApplyPendingState()
     }
 }
 
-GameManager::GameManager() : camera(std::make_unique<PlayerCam>()), renderSnapshot(nullptr) {}
+GameManager::GameManager() : camera(std::make_unique<PlayerCam>()), renderSnapshots(std::make_unique<RenderSnapshotBuffer>()) {}
 GameManager::~GameManager() = default;
@@ -7,6 +7,7 @@
 struct PlayerCam;
 class GameServer;
 struct RenderSnapshot;
+class RenderSnapshotBuffer;
 namespace sol
 {
     class state;
@@ -41,12 +42,36 @@ private:
     std::vector<uint64_t> selectedPawnList;
     Vector2 originalScreenSize;
 
-    // Double-buffered render state
-    std::atomic<std::shared_ptr<RenderSnapshot>> renderSnapshot;
+    // Triple-buffered render state, filled by the simulation thread after every tick
+    std::unique_ptr<RenderSnapshotBuffer> renderSnapshots;
+    std::atomic<Vector2Int> inspectedTile; // Tile the tooltip asks the next snapshot to describe
+
+    std::string recordingPath; // Where each game's commands are saved for replay, with the world seed added to the name. Empty to not record
 
 public:
-    static std::shared_ptr<RenderSnapshot> GetRenderSnapshot();
-    static void SetRenderSnapshot(std::shared_ptr<RenderSnapshot> snap);
+    /**
+     * @return The snapshot taken by the last AcquireRenderSnapshot, nullptr before the first tick.
+     */
+    static const RenderSnapshot *GetRenderSnapshot();
+
+    /**
+     * @brief Switches to the newest snapshot. Called once at the start of a frame,
+     * so every part of the frame draws the same tick.
+     */
+    static void AcquireRenderSnapshot();
+
+    /**
+     * @brief Captures the server's state into a snapshot and publishes it, on the simulation thread.
+     */
+    static void PublishRenderSnapshot(const GameServer &server);
+    static void ResetRenderSnapshots();
+
+    static void SetInspectedTile(const Vector2Int &pos) { GetInstance().inspectedTile.store(pos, std::memory_order_relaxed); }
+
+    /**
+     * @brief Records the commands of every game started from now on, saving them to the file when the game ends.
+     */
+    static void SetRecordingPath(const std::string &path) { GetInstance().recordingPath = path; }
 
     GameManager();
     ~GameManager();
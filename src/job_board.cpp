@@ -0,0 +1,230 @@
+#include "astar.hpp"
+#include "job_board.hpp"
+#include "planned_task.hpp"
+#include "station.hpp"
+#include <numbers>
+
+Vector2Int JobBoard::ToBucket(const Vector2Int &pos)
+{
+    auto floorDiv = [](int value)
+    { return (value >= 0 ? value : value - BUCKET_SIZE + 1) / BUCKET_SIZE; };
+    return {floorDiv(pos.x), floorDiv(pos.y)};
+}
+
+std::vector<JobBoard::Job> *JobBoard::GetBucket(const Vector2Int &bucket)
+{
+    if (buckets.empty() || bucket.x < minBucket.x || bucket.y < minBucket.y || bucket.x > maxBucket.x || bucket.y > maxBucket.y)
+        return nullptr;
+    return &buckets[(bucket.y - minBucket.y) * GetBucketWidth() + (bucket.x - minBucket.x)];
+}
+
+void JobBoard::GrowToInclude(const Vector2Int &bucket)
+{
+    if (GetBucket(bucket))
+        return;
+
+    Vector2Int newMin = buckets.empty() ? bucket : Vector2Int(std::min(minBucket.x, bucket.x), std::min(minBucket.y, bucket.y));
+    Vector2Int newMax = buckets.empty() ? bucket : Vector2Int(std::max(maxBucket.x, bucket.x), std::max(maxBucket.y, bucket.y));
+    int newWidth = newMax.x - newMin.x + 1;
+    std::vector<std::vector<Job>> grown(newWidth * (newMax.y - newMin.y + 1));
+
+    for (int y = minBucket.y; !buckets.empty() && y <= maxBucket.y; ++y)
+        for (int x = minBucket.x; x <= maxBucket.x; ++x)
+            grown[(y - newMin.y) * newWidth + (x - newMin.x)] = std::move(*GetBucket({x, y}));
+
+    buckets = std::move(grown);
+    minBucket = newMin;
+    maxBucket = newMax;
+}
+
+void JobBoard::AddJob(const std::shared_ptr<PlannedTask> &task)
+{
+    if (!task)
+        return;
+
+    Vector2Int bucket = ToBucket(task->position);
+    GrowToInclude(bucket);
+    GetBucket(bucket)->push_back({task->position, task});
+    ++jobCount;
+}
+
+void JobBoard::RemoveJob(const Vector2Int &pos)
+{
+    if (auto bucket = GetBucket(ToBucket(pos)))
+        jobCount -= std::erase_if(*bucket, [&pos](const Job &job)
+                                  { return job.position == pos; });
+}
+
+void JobBoard::Clear()
+{
+    buckets.clear();
+    jobCount = 0;
+}
+
+bool JobBoard::Claim(const std::shared_ptr<PlannedTask> &task, uint64_t pawnId)
+{
+    if (!task || task->claimedBy != 0)
+        return false;
+    task->claimedBy = pawnId;
+    return true;
+}
+
+void JobBoard::Release(const std::shared_ptr<PlannedTask> &task, uint64_t pawnId)
+{
+    if (task && task->claimedBy == pawnId)
+        task->claimedBy = 0;
+}
+
+void JobBoard::GatherOpenJobs(const Vector2 &pos)
+{
+    nearby.clear();
+    if (jobCount == 0)
+        return;
+
+    const Vector2Int center = ToBucket(ToVector2Int(pos));
+    const int maxRing = std::max({center.x - minBucket.x, maxBucket.x - center.x, center.y - minBucket.y, maxBucket.y - center.y});
+    auto isFull = [this]()
+    { return (int)nearby.size() == CANDIDATES_PER_PAWN; };
+
+    auto scanBucket = [&](const Vector2Int &coords)
+    {
+        auto bucket = GetBucket(coords);
+        if (!bucket || bucket->empty())
+            return;
+
+        // Skip the whole bucket when even its nearest tile can't beat the current candidates
+        if (isFull())
+        {
+            float dx = std::max({coords.x * BUCKET_SIZE - pos.x, pos.x - (coords.x * BUCKET_SIZE + BUCKET_SIZE - 1), 0.f});
+            float dy = std::max({coords.y * BUCKET_SIZE - pos.y, pos.y - (coords.y * BUCKET_SIZE + BUCKET_SIZE - 1), 0.f});
+            if (dx * dx + dy * dy >= nearby.back().first)
+                return;
+        }
+
+        for (const auto &job : *bucket)
+        {
+            // Keep the closest candidates, sorted by distance. The task is only loaded for jobs close enough to matter
+            float distSq = Vector2DistanceSq(pos, ToVector2(job.position));
+            if ((isFull() && distSq >= nearby.back().first) || job.task->claimedBy != 0)
+                continue;
+            if (isFull())
+                nearby.pop_back();
+
+            auto insertAt = std::upper_bound(nearby.begin(), nearby.end(), distSq, [](float d, const auto &entry)
+                                             { return d < entry.first; });
+            nearby.insert(insertAt, {distSq, &job.task});
+        }
+    };
+
+    // Scan rings of buckets outwards, until no tile of the next ring can be closer than the farthest candidate
+    for (int ring = 0; ring <= maxRing; ++ring)
+    {
+        const float ringDistance = (float)std::max((ring - 1) * BUCKET_SIZE, 0);
+        if (isFull() && ringDistance * ringDistance >= nearby.back().first)
+            break;
+
+        if (ring == 0)
+            scanBucket(center);
+        else
+        {
+            for (int d = -ring; d <= ring; ++d)
+            {
+                scanBucket(center + Vector2Int(d, -ring));
+                scanBucket(center + Vector2Int(d, ring));
+            }
+            for (int d = -ring + 1; d < ring; ++d)
+            {
+                scanBucket(center + Vector2Int(-ring, d));
+                scanBucket(center + Vector2Int(ring, d));
+            }
+        }
+    }
+}
+
+// Picks the walkable tile next to the task that is closest to the pawn. The task tile itself
+// is never picked, the pawn would stand in the way of what it builds
+static bool FindWorkPosition(const Station &station, const Vector2Int &taskPos, const Vector2 &pawnPos, Vector2 &outPosition)
+{
+    // Nearest first, so usually only one tile has to be looked up
+    std::array<std::pair<float, Vector2Int>, ALL_DIRECTIONS.size()> neighbors;
+    for (size_t i = 0; i < ALL_DIRECTIONS.size(); ++i)
+    {
+        Vector2Int pos = taskPos + DirectionToVector2Int(ALL_DIRECTIONS[i]);
+        neighbors[i] = {Vector2DistanceSq(pawnPos, ToVector2(pos)), pos};
+    }
+    std::ranges::sort(neighbors, {}, &std::pair<float, Vector2Int>::first);
+
+    for (const auto &[distSq, pos] : neighbors)
+    {
+        if (station.tileToPoly.contains(pos))
+        {
+            outPosition = ToVector2(pos);
+            return true;
+        }
+    }
+    return false;
+}
+
+int JobBoard::AssignJobs(const Station &station, std::span<const std::pair<uint64_t, Vector2>> idlePawns, std::vector<Assignment> &outAssignments)
+{
+    outAssignments.clear();
+    if (jobCount == 0 || idlePawns.empty())
+        return 0;
+
+    // Seed every pawn-job pair with a lower bound on its cost: the straight-line distance,
+    // minus the diagonal step that a work position can save
+    candidates.clear();
+    for (int pawnIdx = 0; pawnIdx < (int)idlePawns.size(); ++pawnIdx)
+    {
+        const Vector2 &pawnPos = idlePawns[pawnIdx].second;
+        GatherOpenJobs(pawnPos);
+
+        for (const auto &[distSq, task] : nearby)
+        {
+            if (Vector2IntChebyshev(ToVector2Int(pawnPos), (*task)->position) == 1)
+                candidates.push_back({0.f, pawnIdx, task, pawnPos, true});
+            else
+                candidates.push_back({std::max(std::sqrt(distSq) - std::numbers::sqrt2_v<float>, 0.f), pawnIdx, task, {}, false});
+        }
+    }
+
+    // Greedy matching, cheapest pair first. Path costs are computed lazily: a pair popped with
+    // only its lower bound gets its real cost and goes back in, so pathfinding runs only for
+    // pairs that could actually win
+    auto greater = [](const Candidate &a, const Candidate &b)
+    { return a.cost > b.cost; };
+    std::make_heap(candidates.begin(), candidates.end(), greater);
+    pawnAssigned.assign(idlePawns.size(), 0);
+    auto &pathfinder = Pathfinder::ForCurrentThread();
+    int pathQueries = 0;
+
+    while (!candidates.empty())
+    {
+        std::pop_heap(candidates.begin(), candidates.end(), greater);
+        Candidate candidate = std::move(candidates.back());
+        candidates.pop_back();
+
+        const auto &task = *candidate.task;
+        if (pawnAssigned[candidate.pawnIdx] || task->claimedBy != 0)
+            continue;
+
+        const auto &[pawnId, pawnPos] = idlePawns[candidate.pawnIdx];
+        if (!candidate.isExact)
+        {
+            ++pathQueries;
+            if (!FindWorkPosition(station, task->position, pawnPos, candidate.workPosition) ||
+                !pathfinder.FindPathCost(station.navGraph, pawnPos, candidate.workPosition, candidate.cost))
+                continue;
+
+            candidate.isExact = true;
+            candidates.push_back(std::move(candidate));
+            std::push_heap(candidates.begin(), candidates.end(), greater);
+            continue;
+        }
+
+        Claim(task, pawnId);
+        pawnAssigned[candidate.pawnIdx] = 1;
+        outAssignments.push_back({pawnId, task, candidate.workPosition});
+    }
+    return pathQueries;
+}
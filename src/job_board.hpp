@@ -0,0 +1,74 @@
+#pragma once
+#include "utils.hpp"
+#include <span>
+
+struct PlannedTask;
+struct Station;
+
+/**
+ * @brief Spatial index of the planned tasks that pawns can work on.
+ * Tasks are bucketed by position so nearby work is found without scanning every task,
+ * and each task can be claimed by at most one pawn at a time.
+ */
+class JobBoard
+{
+public:
+    static constexpr int BUCKET_SIZE = 8;         // Side of a spatial bucket, in tiles
+    static constexpr int CANDIDATES_PER_PAWN = 4; // Nearest open jobs whose path cost is evaluated for each pawn
+
+    struct Assignment
+    {
+        uint64_t pawnId;
+        std::shared_ptr<PlannedTask> task;
+        Vector2 workPosition; // Where the pawn stands while working on the task
+    };
+
+    void AddJob(const std::shared_ptr<PlannedTask> &task);
+    void RemoveJob(const Vector2Int &pos);
+    void Clear();
+    size_t GetJobCount() const { return jobCount; }
+
+    static bool Claim(const std::shared_ptr<PlannedTask> &task, uint64_t pawnId);
+    static void Release(const std::shared_ptr<PlannedTask> &task, uint64_t pawnId);
+
+    /**
+     * @brief Matches idle pawns to open jobs, cheapest path cost first.
+     * Each pawn gets at most one job and matched jobs are claimed before returning.
+     *
+     * @param idlePawns Pawn ids with their current positions.
+     * @return How many path cost queries the matching ran, at most CANDIDATES_PER_PAWN per pawn.
+     */
+    int AssignJobs(const Station &station, std::span<const std::pair<uint64_t, Vector2>> idlePawns, std::vector<Assignment> &outAssignments);
+
+private:
+    struct Candidate
+    {
+        float cost; // Path cost if isExact, otherwise a lower bound
+        int pawnIdx;
+        const std::shared_ptr<PlannedTask> *task; // Into a bucket, which stays put during assignment
+        Vector2 workPosition;
+        bool isExact;
+    };
+
+    struct Job
+    {
+        Vector2Int position; // Copied from the task, so distance checks don't have to load it
+        std::shared_ptr<PlannedTask> task;
+    };
+
+    // Dense grid of buckets covering [minBucket, maxBucket], grown as jobs are added further out
+    std::vector<std::vector<Job>> buckets;
+    Vector2Int minBucket, maxBucket;
+    size_t jobCount = 0;
+
+    // Scratch buffers reused between assignment rounds
+    std::vector<std::pair<float, const std::shared_ptr<PlannedTask> *>> nearby;
+    std::vector<Candidate> candidates;
+    std::vector<uint8_t> pawnAssigned;
+
+    static Vector2Int ToBucket(const Vector2Int &pos);
+    int GetBucketWidth() const { return maxBucket.x - minBucket.x + 1; }
+    std::vector<Job> *GetBucket(const Vector2Int &bucket);
+    void GrowToInclude(const Vector2Int &bucket);
+    void GatherOpenJobs(const Vector2 &pos);
+};
@@ -0,0 +1,96 @@
+#include "logger.hpp"
+#include "tracer.hpp"
+#include <utility>
+
+bool LogSite::Allow()
+{
+    int64_t now = std::chrono::steady_clock::now().time_since_epoch().count();
+    int64_t start = windowStart.load(std::memory_order_relaxed);
+    if (now - start >= WINDOW.count() && windowStart.compare_exchange_strong(start, now, std::memory_order_relaxed))
+        inWindow.store(0, std::memory_order_relaxed);
+
+    if (inWindow.fetch_add(1, std::memory_order_relaxed) < MESSAGES_PER_WINDOW)
+        return true;
+
+    suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+LogEntry &LogEntry::operator=(LogEntry &&other) noexcept
+{
+    if (this == &other)
+        return *this;
+
+    Reset();
+    level = other.level;
+    suppressed = other.suppressed;
+    format = other.format;
+    if (other.moveArguments)
+    {
+        other.moveArguments(*this, other);
+        formatArguments = std::exchange(other.formatArguments, nullptr);
+        moveArguments = std::exchange(other.moveArguments, nullptr);
+        destroyArguments = std::exchange(other.destroyArguments, nullptr);
+    }
+    return *this;
+}
+
+void LogEntry::Reset()
+{
+    if (destroyArguments)
+        destroyArguments(*this);
+    formatArguments = nullptr;
+    moveArguments = nullptr;
+    destroyArguments = nullptr;
+}
+
+Logger::Logger()
+{
+    // The writer names itself to the tracer, which must then outlive the logger
+    Tracer::IsRecording();
+    writer = std::thread([this]()
+                         { WriterLoop(); });
+}
+
+Logger::~Logger()
+{
+    stopping.store(true, std::memory_order_release);
+    Wake();
+    if (writer.joinable())
+        writer.join();
+}
+
+void Logger::WriterLoop()
+{
+    Tracer::SetThreadName("Log");
+    while (true)
+    {
+        // Everything pushed before the stop request is printed before returning
+        uint32_t seen = wakeups.load(std::memory_order_acquire);
+        bool stop = stopping.load(std::memory_order_acquire);
+        PrintQueued();
+        if (stop)
+            return;
+        // Returns at once if anything was written since the load above
+        wakeups.wait(seen, std::memory_order_acquire);
+    }
+}
+
+void Logger::PrintQueued()
+{
+    LogEntry entry;
+    if (!queue.TryPop(entry))
+        return;
+
+    TraceZone zone("WriteLog");
+    do
+    {
+        std::string text = entry.formatArguments(entry);
+        if (entry.suppressed > 0)
+            text += std::format(" ({} similar messages suppressed)", entry.suppressed);
+        TraceLog(entry.level, "%s", text.c_str());
+    } while (queue.TryPop(entry));
+
+    if (uint64_t count = dropped.exchange(0, std::memory_order_relaxed); count > 0)
+        TraceLog(LOG_WARNING, "%s", std::format("{} log messages dropped, the log queue was full", count).c_str());
+}
@@ -0,0 +1,174 @@
+#pragma once
+#include "mpsc_ring.hpp"
+#include "utils.hpp"
+#include <chrono>
+#include <new>
+#include <string_view>
+#include <thread>
+#include <tuple>
+
+// Calls below this raylib log level compile to nothing, arguments included
+#ifndef CELESTIUM_MIN_LOG_LEVEL
+#define CELESTIUM_MIN_LOG_LEVEL LOG_INFO
+#endif
+
+/**
+ * @brief Logs a std::format message without formatting or printing it on the calling thread.
+ * The arguments are copied into a queue and formatted on the logger's thread.
+ * Each call site logs a few messages per second at most, the rest are counted and reported with the next one.
+ */
+#define ASYNC_LOG(level, ...)                               \
+    do                                                      \
+    {                                                       \
+        if constexpr ((level) >= CELESTIUM_MIN_LOG_LEVEL)   \
+        {                                                   \
+            static LogSite logSite;                         \
+            if (logSite.Allow())                            \
+                Logger::Write((level), logSite, __VA_ARGS__); \
+        }                                                   \
+    } while (false)
+
+/**
+ * @brief Rate limit of one ASYNC_LOG call site.
+ */
+class LogSite
+{
+public:
+    static constexpr uint32_t MESSAGES_PER_WINDOW = 5;
+    static constexpr std::chrono::steady_clock::duration WINDOW = std::chrono::seconds(1);
+
+    bool Allow();
+
+    /**
+     * @return How many messages were held back since the last call.
+     */
+    uint32_t TakeSuppressed() { return suppressed.exchange(0, std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> windowStart = 0;
+    std::atomic<uint32_t> inWindow = 0;
+    std::atomic<uint32_t> suppressed = 0;
+};
+
+// Pointers to characters are copied, the caller's buffer may be gone by the time the line is formatted
+template <typename T>
+struct LogArgument
+{
+    using type = std::decay_t<T>;
+};
+template <>
+struct LogArgument<const char *>
+{
+    using type = std::string;
+};
+template <>
+struct LogArgument<char *>
+{
+    using type = std::string;
+};
+template <>
+struct LogArgument<std::string_view>
+{
+    using type = std::string;
+};
+
+/**
+ * @brief One queued message: the format string, and its arguments held in place.
+ * Only strings longer than the small-string buffer allocate.
+ */
+struct LogEntry
+{
+    static constexpr size_t STORAGE_SIZE = 192;
+
+    int level = LOG_INFO;
+    uint32_t suppressed = 0;
+    std::string_view format;
+    std::string (*formatArguments)(const LogEntry &entry) = nullptr;
+    void (*moveArguments)(LogEntry &to, LogEntry &from) = nullptr; // Into raw storage, destroying the source
+    void (*destroyArguments)(LogEntry &entry) = nullptr;
+    alignas(std::max_align_t) std::byte storage[STORAGE_SIZE];
+
+    LogEntry() = default;
+    LogEntry(LogEntry &&other) noexcept { *this = std::move(other); }
+    LogEntry &operator=(LogEntry &&other) noexcept;
+    LogEntry(const LogEntry &) = delete;
+    LogEntry &operator=(const LogEntry &) = delete;
+    ~LogEntry() { Reset(); }
+
+    void Reset();
+
+    template <typename... Args>
+    void SetArguments(Args &&...args)
+    {
+        using Stored = std::tuple<typename LogArgument<std::decay_t<Args>>::type...>;
+        static_assert(sizeof(Stored) <= STORAGE_SIZE && alignof(Stored) <= alignof(std::max_align_t), "Log arguments do not fit in a log entry");
+
+        Reset();
+        new (storage) Stored(std::forward<Args>(args)...);
+        formatArguments = [](const LogEntry &entry)
+        {
+            return std::apply([&entry](const auto &...values)
+                              { return std::vformat(entry.format, std::make_format_args(values...)); },
+                              *std::launder(reinterpret_cast<const Stored *>(entry.storage)));
+        };
+        moveArguments = [](LogEntry &to, LogEntry &from)
+        {
+            auto &stored = *std::launder(reinterpret_cast<Stored *>(from.storage));
+            new (to.storage) Stored(std::move(stored));
+            stored.~Stored();
+        };
+        destroyArguments = [](LogEntry &entry)
+        { std::launder(reinterpret_cast<Stored *>(entry.storage))->~Stored(); };
+    }
+};
+
+/**
+ * @brief Prints queued log messages on its own thread, so logging never formats or writes on a hot path.
+ * The queue is allocated up front; when it is full, messages are dropped and counted instead of waiting.
+ */
+class Logger
+{
+public:
+    static constexpr size_t QUEUE_CAPACITY = 1024;
+
+    template <typename... Args>
+    static void Write(int level, LogSite &site, std::format_string<Args...> format, Args &&...args)
+    {
+        LogEntry entry;
+        entry.level = level;
+        entry.suppressed = site.TakeSuppressed();
+        entry.format = format.get();
+        entry.SetArguments(std::forward<Args>(args)...);
+
+        auto &instance = GetInstance();
+        if (!instance.queue.TryPush(std::move(entry)))
+            instance.dropped.fetch_add(1, std::memory_order_relaxed);
+        instance.Wake();
+    }
+
+private:
+    MpscRing<LogEntry, QUEUE_CAPACITY> queue;
+    std::atomic<uint64_t> dropped = 0;
+    std::atomic<bool> stopping = false;
+    std::atomic<uint32_t> wakeups = 0; // Bumped after each write, the writer sleeps until it changes
+    std::thread writer;
+
+    Logger();
+    ~Logger();
+    Logger(const Logger &) = delete;
+    Logger &operator=(const Logger &) = delete;
+
+    static Logger &GetInstance()
+    {
+        static Logger instance;
+        return instance;
+    }
+
+    void Wake()
+    {
+        wakeups.fetch_add(1, std::memory_order_release);
+        wakeups.notify_one();
+    }
+    void WriterLoop();
+    void PrintQueued();
+};
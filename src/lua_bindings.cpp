@@ -1,6 +1,6 @@
-#include "env_effect.hpp"
 #include "lua_bindings.hpp"
 #include "particle_system.hpp"
+#include "render_snapshot.hpp"
 
 namespace
 {
@@ -223,7 +223,7 @@ void register_particle_lua(sol::state &lua)
 float LuaEffect::size() const
 {
     if (auto e = effectRef.lock())
-        return e->GetSize();
+        return e->size;
     return 0.f;
 }
 
@@ -233,8 +233,8 @@ sol::table LuaEffect::position(sol::this_state s) const
     sol::table t = lua.create_table();
     if (auto e = effectRef.lock())
     {
-        t["x"] = e->GetPosition().x;
-        t["y"] = e->GetPosition().y;
+        t["x"] = e->position.x;
+        t["y"] = e->position.y;
     }
     else
     {
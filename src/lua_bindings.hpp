@@ -4,7 +4,7 @@
 void RegisterAllLuaBindings(sol::state &lua);
 
 struct ParticleSystem;
-struct Effect;
+struct EffectRender;
 
 struct LuaParticle
 {
@@ -43,9 +43,9 @@ struct LuaParticleSystem
 
 struct LuaEffect
 {
-    std::weak_ptr<const Effect> effectRef;
+    std::weak_ptr<const EffectRender> effectRef;
     LuaEffect() = default;
-    explicit LuaEffect(const std::shared_ptr<Effect> &e) : effectRef(e) {}
+    explicit LuaEffect(const std::shared_ptr<EffectRender> &e) : effectRef(e) {}
 
     float size() const;
     sol::table position(sol::this_state s) const;
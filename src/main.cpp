@@ -4,18 +4,65 @@
 #include "def_manager.hpp"
 #include "game_state.hpp"
 #include "lua_bindings.hpp"
+#include "profiler.hpp"
+#include "telemetry.hpp"
+#include "tracer.hpp"
 #include "ui_manager.hpp"
 #include "ui.hpp"
 #include "update.hpp"
 
-int main()
+int main(int argc, char **argv)
 {
+    std::string telemetryPath;
+    std::string tracePath;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--telemetry" && i + 1 < argc)
+            telemetryPath = argv[++i];
+        else if (arg == "--trace" && i + 1 < argc)
+            tracePath = argv[++i];
+        else if (arg == "--record" && i + 1 < argc)
+            GameManager::SetRecordingPath(argv[++i]);
+        else
+            TraceLog(TraceLogLevel::LOG_WARNING, std::format("Ignoring unknown argument {}", arg).c_str());
+    }
+
+    // F9 ends the capture early and starts another one into the same file
+    Tracer::SetThreadName("Render");
+    if (!tracePath.empty())
+    {
+        try
+        {
+            Tracer::Start(tracePath);
+        }
+        catch (const std::exception &e)
+        {
+            TraceLog(TraceLogLevel::LOG_ERROR, e.what());
+        }
+    }
+
     SetConfigFlags(FLAG_FULLSCREEN_MODE);
     InitWindow(0, 0, "Celestium");
     SetExitKey(0);
 
     DefinitionManager::ParseConstantsFromFile("../assets/definitions/constants.yml");
 
+    // The command line overrides the telemetry file set in the constants
+    if (telemetryPath.empty())
+        telemetryPath = TELEMETRY_PATH;
+    if (!telemetryPath.empty())
+    {
+        try
+        {
+            TelemetrySink::Start(telemetryPath, TELEMETRY_INTERVAL);
+        }
+        catch (const std::exception &e)
+        {
+            TraceLog(TraceLogLevel::LOG_ERROR, std::format("{}, running without telemetry", e.what()).c_str());
+        }
+    }
+
     GameManager::GetCamera().SetFps(GetMonitorRefreshRate(GetCurrentMonitor()));
     GameManager::SetOriginalScreenSize();
 
@@ -33,8 +80,12 @@ int main()
 
     TraceLog(TraceLogLevel::LOG_INFO, "Initialization Complete");
 
+    // Covers the whole frame, including the wait for the next one
+    const size_t frameProfileSection = Profiler::AddSection("Frame", ProfileDomain::FRAME);
+
     while (GameManager::IsGameRunning())
     {
+        ScopedTimer frameTimer(frameProfileSection);
         BeginDrawing();
         ClearBackground(SPACE_COLOR);
         DrawStarfieldBackground();
@@ -44,6 +95,7 @@ int main()
 
         if (GameManager::IsInGameSim())
         {
+            GameManager::AcquireRenderSnapshot();
             GameManager::GetCamera().HandleMovement();
 
             if (!UiManager::IsMouseOverUiElement())
@@ -57,6 +109,7 @@ int main()
                     HandlePawnHover();
                     HandlePawnSelection();
                     AssignPawnActions();
+                    HandleDoorLock();
                     HandleMouseDrag();
                 }
             }
@@ -84,6 +137,7 @@ int main()
                 DrawDragSelectBox();
                 DrawMainTooltip();
                 DrawFpsCounter();
+                DrawProfilerOverlay();
                 DrawResourceUI();
             }
         }
@@ -92,7 +146,10 @@ int main()
 
         AudioManager::Update();
 
-        EndDrawing();
+        {
+            TraceZone presentZone("EndDrawing");
+            EndDrawing();
+        }
 
         GameManager::ApplyPendingState();
 
@@ -102,6 +159,8 @@ int main()
 
     AssetManager::CleanUp();
     AudioManager::CleanUp();
+    TelemetrySink::Stop();
+    Tracer::Stop();
 
     CloseWindow();
 
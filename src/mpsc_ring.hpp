@@ -0,0 +1,101 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/**
+ * @brief Bounded lock-free queue, pushed from any thread and drained by one.
+ * Every cell carries a sequence number telling whether it is free for the producer of a given lap
+ * or holds an item for the consumer, so producers only race each other on one counter
+ * and never wait on the consumer.
+ */
+template <typename T, size_t Capacity>
+class MpscRing
+{
+public:
+    static constexpr size_t CAPACITY = Capacity;
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "MpscRing capacity must be a power of two");
+
+    MpscRing() : cells(std::make_unique<Cell[]>(CAPACITY))
+    {
+        for (size_t i = 0; i < CAPACITY; ++i)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    MpscRing(const MpscRing &) = delete;
+    MpscRing &operator=(const MpscRing &) = delete;
+
+    /**
+     * @brief Safe to call from any number of threads at once.
+     *
+     * @return false if the ring is full and the item was not taken.
+     */
+    bool TryPush(T &&item)
+    {
+        size_t position = pushPosition.load(std::memory_order_relaxed);
+        Cell *cell;
+        while (true)
+        {
+            cell = &cells[position & (CAPACITY - 1)];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            auto lap = static_cast<std::ptrdiff_t>(sequence - position);
+
+            if (lap == 0)
+            {
+                // The cell is free for this position, claim it before another producer does
+                if (pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (lap < 0)
+            {
+                // The cell still holds an item from the previous lap
+                return false;
+            }
+            else
+            {
+                position = pushPosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->item = std::move(item);
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Takes the oldest item. Only one thread may pop at a time.
+     *
+     * @return false if there is no item ready.
+     */
+    bool TryPop(T &item)
+    {
+        Cell &cell = cells[popPosition & (CAPACITY - 1)];
+        if (cell.sequence.load(std::memory_order_acquire) != popPosition + 1)
+            return false;
+
+        item = std::move(cell.item);
+        cell.sequence.store(popPosition + CAPACITY, std::memory_order_release);
+        ++popPosition;
+        return true;
+    }
+
+    /**
+     * @brief Drops every queued item. Only one thread may pop at a time.
+     */
+    void Clear()
+    {
+        T item;
+        while (TryPop(item))
+            ;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T item;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    alignas(64) std::atomic<size_t> pushPosition = 0;
+    alignas(64) size_t popPosition = 0;
+};
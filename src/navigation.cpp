@@ -0,0 +1,220 @@
+#include "navigation.hpp"
+#include <cmath>
+
+int NavGraph::FindPolygonAt(const Vector2 &pos) const
+{
+    for (int i = 0; i < GetPolygonCount(); ++i)
+    {
+        if (pos.x >= minX[i] && pos.x <= maxX[i] && pos.y >= minY[i] && pos.y <= maxY[i])
+            return i;
+    }
+    return -1;
+}
+
+bool NavGraph::IsSegmentTraversable(const Vector2 &from, const Vector2 &to) const
+{
+    int polyIdx = FindPolygonAt(from);
+    if (polyIdx == -1)
+        return false;
+
+    const Vector2 delta = to - from;
+    const Vector2 step = Vector2Normalize(delta) * .001f; // Nudge past the exit point into the next polygon
+
+    // Polygons are axis-aligned, so walk from rectangle to rectangle along the segment
+    for (int visited = 0; visited < GetPolygonCount(); ++visited)
+    {
+        if (to.x >= minX[polyIdx] && to.x <= maxX[polyIdx] && to.y >= minY[polyIdx] && to.y <= maxY[polyIdx])
+            return true;
+
+        float tExit = 1.f;
+        if (delta.x > 0.f)
+            tExit = std::min(tExit, (maxX[polyIdx] - from.x) / delta.x);
+        else if (delta.x < 0.f)
+            tExit = std::min(tExit, (minX[polyIdx] - from.x) / delta.x);
+        if (delta.y > 0.f)
+            tExit = std::min(tExit, (maxY[polyIdx] - from.y) / delta.y);
+        else if (delta.y < 0.f)
+            tExit = std::min(tExit, (minY[polyIdx] - from.y) / delta.y);
+
+        const Vector2 probe = from + delta * std::max(tExit, 0.f) + step;
+
+        int nextIdx = -1;
+        for (int linkIdx = linkStart[polyIdx]; linkIdx < linkStart[polyIdx + 1]; ++linkIdx)
+        {
+            int target = linkTarget[linkIdx];
+            if (probe.x >= minX[target] && probe.x <= maxX[target] && probe.y >= minY[target] && probe.y <= maxY[target])
+            {
+                if (!linkState[linkIdx].IsBlocked())
+                    nextIdx = target;
+                break;
+            }
+        }
+
+        if (nextIdx == -1)
+            return false;
+        polyIdx = nextIdx;
+    }
+    return false;
+}
+
+void NavGraph::Build(const std::vector<ConvexPolygon> &polygons)
+{
+    const size_t polyCount = polygons.size();
+    size_t linkCount = 0;
+    for (const auto &poly : polygons)
+        linkCount += poly.links.size();
+
+    centerX.resize(polyCount);
+    centerY.resize(polyCount);
+    minX.resize(polyCount);
+    minY.resize(polyCount);
+    maxX.resize(polyCount);
+    maxY.resize(polyCount);
+    linkStart.resize(polyCount + 1);
+
+    linkSource.resize(linkCount);
+    linkTarget.resize(linkCount);
+    portalLeft.resize(linkCount);
+    portalRight.resize(linkCount);
+    portalOffset.resize(linkCount);
+    linkState.assign(linkCount, {});
+    incomingStart.assign(polyCount + 1, 0);
+    incomingLinks.resize(linkCount);
+    polygonFlags.assign(polyCount, NavLinkFlags::NONE);
+    polygonHazardCost.assign(polyCount, 0.f);
+
+    int linkIdx = 0;
+    for (int polyIdx = 0; polyIdx < (int)polyCount; ++polyIdx)
+    {
+        const auto &poly = polygons[polyIdx];
+        const Vector2 center = poly.GetCenter();
+
+        centerX[polyIdx] = center.x;
+        centerY[polyIdx] = center.y;
+        minX[polyIdx] = poly.bounds.x;
+        minY[polyIdx] = poly.bounds.y;
+        maxX[polyIdx] = poly.bounds.x + poly.bounds.width;
+        maxY[polyIdx] = poly.bounds.y + poly.bounds.height;
+        linkStart[polyIdx] = linkIdx;
+
+        for (const auto &link : poly.links)
+        {
+            Vector2 left = link.portalA;
+            Vector2 right = link.portalB;
+
+            // Orient the portal so that left/right are as seen from the source polygon
+            if (Vector2Cross(center, left, right) < 0)
+                std::swap(left, right);
+
+            Vector2 dir = right - left;
+            float distSq = Vector2LengthSq(dir);
+
+            const float minDist = .001f;
+            if (distSq > minDist * minDist)
+            {
+                const float maxPad = PORTAL_PADDING * 2.f;
+                if (distSq <= maxPad * maxPad)
+                {
+                    Vector2 mid = (left + right) * .5f;
+                    left = mid;
+                    right = mid;
+                }
+                else
+                {
+                    Vector2 pad = dir * (PORTAL_PADDING / std::sqrt(distSq));
+                    left += pad;
+                    right -= pad;
+                }
+            }
+
+            // Double-portal padding: one offset into the source polygon, one into the target
+            Vector2 normal = {0, 0};
+            if (link.edgeIdx == 0)
+                normal.y = 1; // North edge
+            else if (link.edgeIdx == 1)
+                normal.x = -1; // East
+            else if (link.edgeIdx == 2)
+                normal.y = -1; // South
+            else if (link.edgeIdx == 3)
+                normal.x = 1; // West
+
+            linkSource[linkIdx] = polyIdx;
+            linkTarget[linkIdx] = link.targetPolyIdx;
+            portalLeft[linkIdx] = left;
+            portalRight[linkIdx] = right;
+            portalOffset[linkIdx] = normal * PORTAL_PADDING;
+            ++linkIdx;
+
+            ++incomingStart[link.targetPolyIdx + 1];
+            if (!link.door.expired())
+                polygonFlags[link.targetPolyIdx] = NavLinkFlags::DOOR;
+        }
+    }
+    linkStart[polyCount] = linkIdx;
+
+    // Bucket links by target polygon so state changes only touch the affected links
+    for (size_t i = 0; i < polyCount; ++i)
+        incomingStart[i + 1] += incomingStart[i];
+
+    std::vector<int> fill(incomingStart.begin(), incomingStart.end() - 1);
+    for (int i = 0; i < (int)linkCount; ++i)
+        incomingLinks[fill[linkTarget[i]]++] = i;
+
+    for (int i = 0; i < (int)polyCount; ++i)
+        RefreshIncomingLinks(i);
+    ++version;
+}
+
+void NavGraph::SetDoorState(int polyIdx, bool powered, bool locked, bool open)
+{
+    if (polyIdx < 0 || polyIdx >= GetPolygonCount())
+        return;
+
+    NavLinkFlags flags = NavLinkFlags::DOOR;
+    if (powered)
+        flags |= NavLinkFlags::POWERED;
+    if (locked)
+        flags |= NavLinkFlags::LOCKED;
+    if (open)
+        flags |= NavLinkFlags::OPEN;
+
+    if (polygonFlags[polyIdx] == flags)
+        return;
+
+    polygonFlags[polyIdx] = flags;
+    RefreshIncomingLinks(polyIdx);
+}
+
+void NavGraph::SetHazardCost(int polyIdx, float cost)
+{
+    if (polyIdx < 0 || polyIdx >= GetPolygonCount() || polygonHazardCost[polyIdx] == cost)
+        return;
+
+    polygonHazardCost[polyIdx] = cost;
+    RefreshIncomingLinks(polyIdx);
+}
+
+void NavGraph::RefreshIncomingLinks(int polyIdx)
+{
+    NavLinkState state;
+    state.flags = polygonFlags[polyIdx];
+    state.cost = polygonHazardCost[polyIdx];
+
+    if (magic_enum::enum_flags_test_any(state.flags, NavLinkFlags::DOOR))
+    {
+        state.cost += DOOR_PENALTY;
+
+        // Unpowered doors cannot be opened, locked ones must not be
+        if (!magic_enum::enum_flags_test_any(state.flags, NavLinkFlags::POWERED) ||
+            magic_enum::enum_flags_test_any(state.flags, NavLinkFlags::LOCKED))
+            state.flags |= NavLinkFlags::BLOCKED;
+    }
+
+    for (int i = incomingStart[polyIdx]; i < incomingStart[polyIdx + 1]; ++i)
+    {
+        NavLinkState &linkSt = linkState[incomingLinks[i]];
+        if (linkSt.IsBlocked() != state.IsBlocked())
+            ++version;
+        linkSt = state;
+    }
+}
@@ -43,6 +43,15 @@ struct ConvexPolygon {
     }
 };
 
+/**
+ * @brief How rooms are split into convex polygons.
+ */
+enum class NavDecomposition : uint8_t
+{
+    GREEDY,   // Grow rectangles from the top-left remaining tile
+    MAX_RECT, // Bitmap scan taking the largest rectangle at each anchor tile, by rows or columns
+};
+
 /**
  * @brief Represents a metadata container for a walkable area.
  * Rooms are collections of convex polygons.
@@ -51,3 +60,93 @@ struct Room {
     int id = -1;
     std::vector<int> polygonIds;
 };
+
+enum class NavLinkFlags : uint8_t
+{
+    NONE = 0,
+    DOOR = 1 << 0,
+    POWERED = 1 << 1,
+    LOCKED = 1 << 2,
+    OPEN = 1 << 3,
+    BLOCKED = 1 << 4, // Derived from the flags above, the only bit the pathfinder checks
+};
+
+template <>
+struct magic_enum::customize::enum_range<NavLinkFlags>
+{
+    static constexpr bool is_flags = true;
+};
+
+/**
+ * @brief Dynamic traversal state of a link, read by the pathfinder in a single load.
+ * Describes the polygon the link leads into, so every link into a door shares its state.
+ */
+struct NavLinkState
+{
+    float cost = 0.f; // Extra cost on top of the travel distance, in tiles
+    NavLinkFlags flags = NavLinkFlags::NONE;
+
+    bool IsBlocked() const { return magic_enum::enum_flags_test_any(flags, NavLinkFlags::BLOCKED); }
+};
+
+/**
+ * @brief Flattened copy of the navigation polygons, laid out for the pathfinder.
+ * Each field is stored in its own array. The links of polygon i occupy the range
+ * [linkStart[i], linkStart[i + 1]) of the per-link arrays.
+ */
+struct NavGraph
+{
+    static constexpr float PORTAL_PADDING = .5f;
+    static constexpr float DOOR_PENALTY = 5.f; // Extra cost of passing a door, in tiles
+
+    // Per-polygon data
+    std::vector<float> centerX, centerY;
+    std::vector<float> minX, minY, maxX, maxY;
+    std::vector<int> linkStart;
+
+    // Per-link data
+    std::vector<int> linkSource;
+    std::vector<int> linkTarget;
+    std::vector<Vector2> portalLeft, portalRight; // Oriented from the source polygon and shrunk by the padding
+    std::vector<Vector2> portalOffset;            // Padding offset pointing into the source polygon
+    std::vector<NavLinkState> linkState;
+
+    // Links entering polygon i occupy [incomingStart[i], incomingStart[i + 1]) of incomingLinks
+    std::vector<int> incomingStart;
+    std::vector<int> incomingLinks;
+
+    // Per-polygon inputs the link states are derived from
+    std::vector<NavLinkFlags> polygonFlags;
+    std::vector<float> polygonHazardCost;
+
+    // Bumped whenever existing paths may have become invalid (rebuild or a link getting blocked/unblocked)
+    uint32_t version = 0;
+
+    int GetPolygonCount() const { return (int)centerX.size(); }
+    int GetLinkCount() const { return (int)linkTarget.size(); }
+    Vector2 GetCenter(int polyIdx) const { return {centerX[polyIdx], centerY[polyIdx]}; }
+
+    int FindPolygonAt(const Vector2 &pos) const;
+
+    /**
+     * @brief Checks that walking the straight segment stays on the graph and never enters a blocked link.
+     */
+    bool IsSegmentTraversable(const Vector2 &from, const Vector2 &to) const;
+
+    void Build(const std::vector<ConvexPolygon> &polygons);
+
+    /**
+     * @brief Updates the state of a door polygon and of every link leading into it.
+     */
+    void SetDoorState(int polyIdx, bool powered, bool locked, bool open);
+
+    /**
+     * @brief Sets an extra cost for entering a polygon, e.g. to steer pawns away from hazards.
+     * Takes effect on the next query without rebuilding the graph.
+     */
+    void SetHazardCost(int polyIdx, float cost);
+    float GetHazardCost(int polyIdx) const { return polygonHazardCost[polyIdx]; }
+
+private:
+    void RefreshIncomingLinks(int polyIdx);
+};
@@ -3,28 +3,10 @@
 
 std::string Pawn::GetActionName() const
 {
-    if (actionQueue.empty())
+    if (actionQueue.IsEmpty())
         return "Idle";
 
-    return actionQueue.front()->GetActionName();
-}
-
-std::string Pawn::GetInfo() const
-{
-    std::string info = " - " + GetName();
-
-    if (IsAlive())
-    {
-        info += std::format("\n   + Health: {:.1f}", GetHealth());
-        info += std::format("\n   + Oxygen: {:.0f}", GetOxygen());
-        info += std::format("\n   + Action: {}", GetActionName());
-    }
-    else
-    {
-        info += "\n   + DEAD";
-    }
-
-    return info;
+    return ::GetActionName(actionQueue.Front());
 }
 
 std::atomic<uint64_t> Pawn::nextInstanceId{1};
\ No newline at end of file
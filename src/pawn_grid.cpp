@@ -0,0 +1,103 @@
+#include "pawn_grid.hpp"
+
+Vector2Int PawnGrid::ToCell(const Vector2 &pos) const
+{
+    return ToVector2Int(pos / cellSize);
+}
+
+void PawnGrid::Rebuild(std::span<const Vector2> positions)
+{
+    slots.resize(positions.size());
+    slotPositions.resize(positions.size());
+    if (positions.empty())
+    {
+        width = height = 0;
+        cellStart.assign(1, 0);
+        return;
+    }
+
+    Vector2 min = positions[0], max = positions[0];
+    for (const Vector2 &pos : positions)
+    {
+        min = Vector2(std::min(min.x, pos.x), std::min(min.y, pos.y));
+        max = Vector2(std::max(max.x, pos.x), std::max(max.y, pos.y));
+    }
+
+    // Coarsen the cells if stray pawns stretch the bounds too far
+    const size_t cellLimit = std::max(positions.size() * 4, MIN_CELL_LIMIT);
+    cellSize = BASE_CELL_SIZE;
+    while (true)
+    {
+        minCell = ToCell(min);
+        Vector2Int maxCell = ToCell(max);
+        width = maxCell.x - minCell.x + 1;
+        height = maxCell.y - minCell.y + 1;
+        if ((size_t)width * height <= cellLimit)
+            break;
+        cellSize *= 2.f;
+    }
+
+    auto cellIndex = [this](const Vector2 &pos)
+    {
+        Vector2Int cell = ToCell(pos) - minCell;
+        return cell.y * width + cell.x;
+    };
+
+    // Counting sort by cell: count, prefix sum, then scatter using cellStart as the cursor
+    cellStart.assign((size_t)width * height + 1, 0);
+    for (const Vector2 &pos : positions)
+        ++cellStart[cellIndex(pos) + 1];
+    for (size_t i = 1; i < cellStart.size(); ++i)
+        cellStart[i] += cellStart[i - 1];
+
+    for (uint32_t slot = 0; slot < positions.size(); ++slot)
+    {
+        uint32_t index = cellStart[cellIndex(positions[slot])]++;
+        slots[index] = slot;
+        slotPositions[index] = positions[slot];
+    }
+
+    // Scattering advanced each start to the next cell's start, shift them back
+    for (size_t i = cellStart.size() - 1; i > 0; --i)
+        cellStart[i] = cellStart[i - 1];
+    cellStart[0] = 0;
+}
+
+template <typename Predicate>
+void PawnGrid::Query(const Vector2 &min, const Vector2 &max, Predicate pred, std::vector<uint32_t> &outSlots) const
+{
+    outSlots.clear();
+    if (width == 0)
+        return;
+
+    Vector2Int from = ToCell(min) - minCell;
+    Vector2Int to = ToCell(max) - minCell;
+    if (to.x < 0 || to.y < 0 || from.x >= width || from.y >= height)
+        return;
+
+    from = Vector2Int(std::max(from.x, 0), std::max(from.y, 0));
+    to = Vector2Int(std::min(to.x, width - 1), std::min(to.y, height - 1));
+
+    for (int y = from.y; y <= to.y; ++y)
+    {
+        // Cells of a row are adjacent, so the row's pawns are one contiguous run
+        uint32_t begin = cellStart[y * width + from.x];
+        uint32_t end = cellStart[y * width + to.x + 1];
+        for (uint32_t i = begin; i < end; ++i)
+            if (pred(slotPositions[i]))
+                outSlots.push_back(slots[i]);
+    }
+}
+
+void PawnGrid::QueryRect(const Rectangle &rect, std::vector<uint32_t> &outSlots) const
+{
+    Query(Vector2(rect.x, rect.y), Vector2(rect.x + rect.width, rect.y + rect.height), [&rect](const Vector2 &pos)
+          { return IsVector2WithinRect(rect, pos); }, outSlots);
+}
+
+void PawnGrid::QueryRadius(const Vector2 &center, float radius, std::vector<uint32_t> &outSlots) const
+{
+    const float radiusSq = radius * radius;
+    Query(center - Vector2(radius, radius), center + Vector2(radius, radius), [&center, radiusSq](const Vector2 &pos)
+          { return Vector2DistanceSq(center, pos) <= radiusSq; }, outSlots);
+}
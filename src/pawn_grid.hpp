@@ -0,0 +1,37 @@
+#pragma once
+#include "utils.hpp"
+#include <span>
+
+/**
+ * @brief Uniform grid over pawn positions for radius and rectangle queries.
+ * Rebuilt from the position array with a counting sort, so each cell is a contiguous
+ * run of pawn slots and a query only visits the cells it overlaps.
+ */
+class PawnGrid
+{
+public:
+    static constexpr float BASE_CELL_SIZE = 4.f; // Side of a cell in tiles, doubled while the grid would exceed the cell limit
+    static constexpr size_t MIN_CELL_LIMIT = 4096;
+
+    void Rebuild(std::span<const Vector2> positions);
+    size_t Size() const { return slots.size(); }
+
+    /**
+     * @brief Collects the slots of pawns within the rectangle, edges included.
+     */
+    void QueryRect(const Rectangle &rect, std::vector<uint32_t> &outSlots) const;
+    void QueryRadius(const Vector2 &center, float radius, std::vector<uint32_t> &outSlots) const;
+
+private:
+    float cellSize = BASE_CELL_SIZE;
+    Vector2Int minCell;
+    int width = 0, height = 0;
+
+    std::vector<uint32_t> cellStart;     // Slots of cell i occupy [cellStart[i], cellStart[i + 1])
+    std::vector<uint32_t> slots;         // Pawn slots ordered by cell
+    std::vector<Vector2> slotPositions;  // Positions in the same order, so queries read them sequentially
+
+    Vector2Int ToCell(const Vector2 &pos) const;
+    template <typename Predicate>
+    void Query(const Vector2 &min, const Vector2 &max, Predicate pred, std::vector<uint32_t> &outSlots) const;
+};
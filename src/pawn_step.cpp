@@ -0,0 +1,34 @@
+#include "component.hpp"
+#include "env_effect.hpp"
+#include "pawn_step.hpp"
+#include "planned_task.hpp"
+#include "station.hpp"
+#include "tile.hpp"
+
+void ApplySharedWrite(Station &station, SharedWrite &write)
+{
+    std::visit(
+        [&station](auto &concrete)
+        {
+            using T = std::decay_t<decltype(concrete)>;
+            if constexpr (std::is_same_v<T, OpenDoorWrite>)
+                concrete.door->Open(concrete.duration);
+            else if constexpr (std::is_same_v<T, CloseDoorWrite>)
+                concrete.door->Close();
+            else if constexpr (std::is_same_v<T, RemoveEffectWrite>)
+            {
+                // Several pawns may have put out the same fire, removing it again is a no-op
+                station.RemoveEffect(concrete.effect);
+            }
+            else if constexpr (std::is_same_v<T, RepairWrite>)
+                concrete.durability->SetHitpoints(std::min(concrete.durability->GetHitpoints() + concrete.amount, concrete.durability->GetMaxHitpoints()));
+            else if constexpr (std::is_same_v<T, BuildWrite>)
+            {
+                bool wasComplete = concrete.task->progress >= 1.f;
+                concrete.task->progress += concrete.amount;
+                if (!wasComplete && concrete.task->progress >= 1.f)
+                    station.CompletePlannedTask(concrete.task->position);
+            }
+        },
+        write);
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include "utils.hpp"
+#include <variant>
+
+struct DoorComponent;
+struct DurabilityComponent;
+struct Effect;
+struct PawnTable;
+struct PlannedTask;
+struct Station;
+
+// Writes to state shared between pawns, deferred out of the parallel pawn phase
+struct OpenDoorWrite
+{
+    std::shared_ptr<DoorComponent> door;
+    float duration;
+};
+
+struct CloseDoorWrite
+{
+    std::shared_ptr<DoorComponent> door;
+};
+
+struct RemoveEffectWrite
+{
+    std::shared_ptr<Effect> effect;
+};
+
+struct RepairWrite
+{
+    std::shared_ptr<DurabilityComponent> durability;
+    float amount;
+};
+
+struct BuildWrite
+{
+    std::shared_ptr<PlannedTask> task;
+    float amount;
+};
+
+using SharedWrite = std::variant<OpenDoorWrite, CloseDoorWrite, RemoveEffectWrite, RepairWrite, BuildWrite>;
+using SharedWriteList = std::vector<std::pair<uint32_t, SharedWrite>>;
+
+/**
+ * @brief What a pawn's action may touch while pawns are updated in parallel.
+ * The action may change its own slot of the table and its own Pawn record. Writes to
+ * anything shared go through Defer and are applied afterwards, in slot order.
+ */
+struct PawnStep
+{
+    PawnTable &pawns;
+    uint32_t slot;
+    SharedWriteList &writes;
+
+    void Defer(SharedWrite &&write) { writes.emplace_back(slot, std::move(write)); }
+};
+
+void ApplySharedWrite(Station &station, SharedWrite &write);
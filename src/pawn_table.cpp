@@ -0,0 +1,137 @@
+#include "pawn.hpp"
+#include "pawn_table.hpp"
+
+std::optional<uint32_t> PawnTable::GetSlot(uint64_t id) const
+{
+    if (auto it = slotById.find(id); it != slotById.end())
+        return it->second;
+    return std::nullopt;
+}
+
+uint32_t PawnTable::Add(const std::shared_ptr<Pawn> &pawn, const Vector2 &position)
+{
+    if (!pawn)
+        throw std::runtime_error("Cannot add a null pawn to the pawn table");
+
+    uint32_t slot = (uint32_t)ids.size();
+    if (!slotById.try_emplace(pawn->GetInstanceId(), slot).second)
+        throw std::runtime_error(std::format("Pawn {} is already in the pawn table", pawn->GetInstanceId()));
+
+    ids.push_back(pawn->GetInstanceId());
+    positions.push_back(position);
+    oxygen.push_back(PAWN_OXYGEN_MAX);
+    health.push_back(PAWN_HEALTH_MAX);
+    alive.push_back(1);
+    cells.push_back(ToVector2Int(position));
+    floors.emplace_back();
+    pawns.push_back(pawn);
+    lods.push_back(SimLod::FULL);
+    pendingTime.push_back(0.f);
+    stepTime.push_back(0.f);
+    return slot;
+}
+
+void PawnTable::Remove(uint64_t id)
+{
+    auto it = slotById.find(id);
+    if (it == slotById.end())
+        return;
+
+    // Move the last pawn into the freed slot to keep the arrays dense
+    uint32_t slot = it->second;
+    uint32_t last = (uint32_t)ids.size() - 1;
+    slotById.erase(it);
+    if (slot != last)
+    {
+        ids[slot] = ids[last];
+        positions[slot] = positions[last];
+        oxygen[slot] = oxygen[last];
+        health[slot] = health[last];
+        alive[slot] = alive[last];
+        cells[slot] = cells[last];
+        floors[slot] = std::move(floors[last]);
+        pawns[slot] = std::move(pawns[last]);
+        lods[slot] = lods[last];
+        pendingTime[slot] = pendingTime[last];
+        stepTime[slot] = stepTime[last];
+        slotById[ids[slot]] = slot;
+    }
+
+    ids.pop_back();
+    positions.pop_back();
+    oxygen.pop_back();
+    health.pop_back();
+    alive.pop_back();
+    cells.pop_back();
+    floors.pop_back();
+    pawns.pop_back();
+    lods.pop_back();
+    pendingTime.pop_back();
+    stepTime.pop_back();
+}
+
+void PawnTable::Clear()
+{
+    ids.clear();
+    positions.clear();
+    oxygen.clear();
+    health.clear();
+    alive.clear();
+    cells.clear();
+    floors.clear();
+    pawns.clear();
+    lods.clear();
+    pendingTime.clear();
+    stepTime.clear();
+    slotById.clear();
+}
+
+void PawnTable::SetHealth(uint32_t slot, float newHealth)
+{
+    if (!alive[slot])
+        return;
+
+    health[slot] = std::clamp(newHealth, 0.f, PAWN_HEALTH_MAX);
+    if (health[slot] <= 0)
+        Kill(slot);
+}
+
+void PawnTable::Kill(uint32_t slot)
+{
+    alive[slot] = 0;
+    oxygen[slot] = 0;
+    health[slot] = 0;
+    pawns[slot]->GetActionQueue().Clear();
+}
+
+void PawnTable::BeginStep(float deltaTime, uint64_t tick)
+{
+    const uint64_t interval = (uint64_t)std::max(SIM_LOD_INTERVAL, 1);
+    for (uint32_t slot = 0; slot < ids.size(); ++slot)
+    {
+        pendingTime[slot] += deltaTime;
+        bool isDue = lods[slot] == SimLod::FULL || (slot + tick) % interval == 0;
+        stepTime[slot] = isDue ? pendingTime[slot] : 0.f;
+        pendingTime[slot] = isDue ? 0.f : pendingTime[slot];
+    }
+}
+
+void PawnTable::ConsumeOxygen()
+{
+    for (uint32_t slot = 0; slot < oxygen.size(); ++slot)
+        oxygen[slot] -= alive[slot] ? PAWN_OXYGEN_USE * stepTime[slot] : 0.f;
+
+    for (uint32_t slot = 0; slot < oxygen.size(); ++slot)
+        if (alive[slot] && oxygen[slot] <= 0)
+            Kill(slot);
+}
+
+void PawnTable::RefillOxygen(uint32_t slot, float &sourceOxygen)
+{
+    if (!alive[slot] || oxygen[slot] >= PAWN_OXYGEN_MAX || sourceOxygen <= 0.f)
+        return;
+
+    float usedOxygen = std::min(std::min(sourceOxygen, PAWN_OXYGEN_REFILL * stepTime[slot]), PAWN_OXYGEN_MAX - oxygen[slot]);
+    oxygen[slot] += usedOxygen;
+    sourceOxygen -= usedOxygen;
+}
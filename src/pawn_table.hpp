@@ -0,0 +1,66 @@
+#pragma once
+#include "utils.hpp"
+#include <unordered_map>
+
+struct Pawn;
+struct Tile;
+
+/**
+ * @brief How often a pawn's environment is stepped.
+ */
+enum class SimLod : uint8_t
+{
+    FULL,    // Every tick
+    REDUCED, // Every SIM_LOD_INTERVAL ticks, integrating the skipped time in one step
+};
+
+/**
+ * @brief Dense storage of every pawn, with the state touched each tick split into one array per field.
+ * All arrays are indexed by slot. Slots move when pawns are removed, so anything kept across
+ * ticks refers to pawns by id and resolves the slot with GetSlot.
+ */
+struct PawnTable
+{
+    std::vector<uint64_t> ids;
+    std::vector<Vector2> positions;
+    std::vector<float> oxygen;
+    std::vector<float> health;
+    std::vector<uint8_t> alive;
+    std::vector<Vector2Int> cells;            // Tile position the pawn stands on
+    std::vector<std::weak_ptr<Tile>> floors;  // Floor tile at the cell, expired over empty space
+    std::vector<std::shared_ptr<Pawn>> pawns; // Rarely touched state: name, color, action queue
+    std::vector<SimLod> lods;
+    std::vector<float> pendingTime; // Time passed since the pawn's last environment step
+    std::vector<float> stepTime;    // Time integrated by this tick's step, zero if the pawn is skipped
+
+    size_t Size() const { return ids.size(); }
+    std::optional<uint32_t> GetSlot(uint64_t id) const;
+
+    uint32_t Add(const std::shared_ptr<Pawn> &pawn, const Vector2 &position);
+    void Remove(uint64_t id);
+    void Clear();
+
+    void SetHealth(uint32_t slot, float newHealth);
+    void Kill(uint32_t slot);
+
+    /**
+     * @brief Promoting a pawn keeps its pending time, which is caught up at its next step.
+     */
+    void SetLod(uint32_t slot, SimLod lod) { lods[slot] = lod; }
+
+    /**
+     * @brief Advances time and fills stepTime for the pawns stepped this tick.
+     * Reduced pawns are staggered by slot so their catch-up steps spread over the interval.
+     * Ids are not used, they depend on how many pawns the process created before.
+     */
+    void BeginStep(float deltaTime, uint64_t tick);
+
+    /**
+     * @brief Drains oxygen from every living pawn over its step time, killing those that run out.
+     */
+    void ConsumeOxygen();
+    void RefillOxygen(uint32_t slot, float &sourceOxygen);
+
+private:
+    std::unordered_map<uint64_t, uint32_t> slotById;
+};
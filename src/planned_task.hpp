@@ -11,6 +11,7 @@ struct PlannedTask
     bool isBuild;
     float progress;
     Rotation rotation;
+    uint64_t claimedBy = 0; // Instance id of the pawn working on this task, 0 if unclaimed
     mutable std::shared_ptr<Tile> previewTile = nullptr;
 
     PlannedTask(const Vector2Int &position, const std::string &tileId, bool isBuild, Rotation rotation = Rotation::UP, float progress = 0.f)
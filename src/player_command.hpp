@@ -0,0 +1,45 @@
+#pragma once
+#include "direction.hpp"
+#include "mpsc_ring.hpp"
+#include "utils.hpp"
+#include <optional>
+#include <variant>
+
+struct MovePawnCommand
+{
+    uint64_t pawnId;
+    Vector2 targetPosition;
+};
+
+struct ClearPawnActionsCommand
+{
+    uint64_t pawnId;
+};
+
+struct PlanTaskCommand
+{
+    Vector2Int position;
+    std::string tileId;
+    bool isBuild;
+    Rotation rotation;
+};
+
+struct CancelTaskCommand
+{
+    Vector2Int position;
+};
+
+struct ToggleDoorLockCommand
+{
+    Vector2Int position;
+};
+
+struct PauseCommand
+{
+    std::optional<bool> paused; // Toggles the pause when empty
+};
+
+using PlayerCommand = std::variant<MovePawnCommand, ClearPawnActionsCommand, PlanTaskCommand, CancelTaskCommand, ToggleDoorLockCommand, PauseCommand>;
+
+// Pushed by the render thread and drained by the simulation at the start of a tick
+using CommandRing = MpscRing<PlayerCommand, 1024>;
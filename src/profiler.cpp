@@ -0,0 +1,128 @@
+#include "profiler.hpp"
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+// Section this thread's allocations are attributed to, and the allocations not yet added to it.
+// Both are constant-initialized, so operator new can touch them at any point of a thread's life
+static thread_local size_t currentSection = Profiler::NO_SECTION;
+static thread_local AllocationCount pendingAllocations;
+
+#ifdef CELESTIUM_COUNT_ALLOCATIONS
+// Array and nothrow forms of new and delete forward to these, aligned forms stay uncounted
+void *operator new(std::size_t size)
+{
+    ++pendingAllocations.count;
+    pendingAllocations.bytes += size;
+    if (void *memory = std::malloc(size > 0 ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+#endif
+
+size_t Profiler::AddSection(const std::string &name, ProfileDomain domain)
+{
+    auto &instance = GetInstance();
+    std::lock_guard<std::mutex> lock(instance.registerMutex);
+
+    size_t count = instance.sectionCount.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (instance.sections[i].name == name)
+            return i;
+    }
+
+    if (count == MAX_SECTIONS)
+        throw std::runtime_error(std::format("Profiler section limit of {} reached by section {}", MAX_SECTIONS, name));
+
+    instance.sections[count].name = name;
+    instance.sections[count].domain = domain;
+    instance.sectionCount.store(count + 1, std::memory_order_release);
+    return count;
+}
+
+void Profiler::Record(size_t section, std::chrono::steady_clock::duration elapsed, const AllocationCount &allocations)
+{
+    // A section is only ever run by one thread at a time, so the count needs no read-modify-write
+    auto &data = GetInstance().sections[section];
+    uint64_t index = data.count.load(std::memory_order_relaxed);
+    data.samples[index % HISTORY].store(std::chrono::duration<float, std::milli>(elapsed).count(), std::memory_order_relaxed);
+    data.allocationSamples[index % HISTORY].store((uint32_t)std::min<uint64_t>(allocations.count, UINT32_MAX), std::memory_order_relaxed);
+    data.allocatedBytesSamples[index % HISTORY].store(allocations.bytes, std::memory_order_relaxed);
+    data.count.store(index + 1, std::memory_order_release);
+}
+
+AllocationCount Profiler::GetAllocationSample(size_t section, uint64_t index)
+{
+    auto &data = GetInstance().sections[section];
+    return {data.allocationSamples[index % HISTORY].load(std::memory_order_relaxed),
+            data.allocatedBytesSamples[index % HISTORY].load(std::memory_order_relaxed)};
+}
+
+size_t Profiler::SwapCurrentSection(size_t section)
+{
+    if (currentSection != NO_SECTION && pendingAllocations.count > 0)
+    {
+        auto &data = GetInstance().sections[currentSection];
+        data.allocationTotal.fetch_add(pendingAllocations.count, std::memory_order_relaxed);
+        data.allocatedBytesTotal.fetch_add(pendingAllocations.bytes, std::memory_order_relaxed);
+    }
+    // Allocations outside every section are dropped
+    pendingAllocations = AllocationCount();
+
+    return std::exchange(currentSection, section);
+}
+
+size_t Profiler::GetCurrentSection()
+{
+    return currentSection;
+}
+
+AllocationCount Profiler::GetAllocationTotal(size_t section)
+{
+    auto &data = GetInstance().sections[section];
+    return {data.allocationTotal.load(std::memory_order_relaxed), data.allocatedBytesTotal.load(std::memory_order_relaxed)};
+}
+
+ProfileStats Profiler::GetStats(size_t section, size_t window)
+{
+    uint64_t count = GetSampleCount(section);
+    size_t kept = (size_t)std::min<uint64_t>(count, std::min(window, HISTORY));
+    if (kept == 0)
+        return ProfileStats();
+
+    std::array<float, HISTORY> sorted;
+    float sum = 0;
+    AllocationCount allocations;
+    for (size_t i = 0; i < kept; ++i)
+    {
+        sorted[i] = GetSample(section, count - kept + i);
+        sum += sorted[i];
+
+        AllocationCount sample = GetAllocationSample(section, count - kept + i);
+        allocations.count += sample.count;
+        allocations.bytes += sample.bytes;
+    }
+
+    ProfileStats stats;
+    stats.average = sum / kept;
+    stats.allocations = (float)allocations.count / kept;
+    stats.allocatedBytes = (float)allocations.bytes / kept;
+    stats.last = sorted[kept - 1];
+
+    size_t p99Index = std::min(kept - 1, (size_t)std::ceil(kept * .99) - 1);
+    std::nth_element(sorted.begin(), sorted.begin() + p99Index, sorted.begin() + kept);
+    stats.p99 = sorted[p99Index];
+    stats.max = *std::max_element(sorted.begin(), sorted.begin() + kept);
+    return stats;
+}
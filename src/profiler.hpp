@@ -0,0 +1,158 @@
+#pragma once
+#include "tracer.hpp"
+#include "utils.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+enum class ProfileDomain : uint8_t
+{
+    TICK,       // A whole fixed tick, wall time
+    TICK_PHASE, // Part of a tick; phases may run at the same time, so their sum can exceed the tick
+    FRAME,      // A render pass, once per drawn frame
+};
+
+struct AllocationCount
+{
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+
+    AllocationCount operator-(const AllocationCount &other) const { return {count - other.count, bytes - other.bytes}; }
+};
+
+struct ProfileStats
+{
+    float average = 0; // Milliseconds, over the kept samples
+    float p99 = 0;
+    float max = 0;
+    float last = 0;
+    float allocations = 0; // Average per sample, only counted in allocation counting builds
+    float allocatedBytes = 0;
+};
+
+/**
+ * @brief Keeps the latest timings of named sections of the tick and the frame.
+ * Each section has a ring of atomic samples, written by whichever thread runs the section
+ * and read by the overlay without locks. A read racing a write may see a sample of the newer lap,
+ * which only nudges the rolling statistics.
+ *
+ * Built with CELESTIUM_COUNT_ALLOCATIONS, the global operator new also counts heap allocations
+ * per thread. They are attributed to the section the thread is in, and jobs queued from a section
+ * count towards it wherever they run.
+ */
+class Profiler
+{
+public:
+    static constexpr size_t MAX_SECTIONS = 64;
+    static constexpr size_t HISTORY = 256; // Samples kept per section
+    static constexpr size_t NO_SECTION = SIZE_MAX;
+#ifdef CELESTIUM_COUNT_ALLOCATIONS
+    static constexpr bool COUNTS_ALLOCATIONS = true;
+#else
+    static constexpr bool COUNTS_ALLOCATIONS = false;
+#endif
+
+    /**
+     * @brief Registers a section, or returns the existing one with the same name.
+     */
+    static size_t AddSection(const std::string &name, ProfileDomain domain);
+
+    /**
+     * @brief Adds a sample to the section. A section must not be recorded from two threads at once.
+     */
+    static void Record(size_t section, std::chrono::steady_clock::duration elapsed, const AllocationCount &allocations = {});
+
+    static size_t GetSectionCount() { return GetInstance().sectionCount.load(std::memory_order_acquire); }
+    static const std::string &GetSectionName(size_t section) { return GetInstance().sections[section].name; }
+    static ProfileDomain GetSectionDomain(size_t section) { return GetInstance().sections[section].domain; }
+
+    /**
+     * @return How many samples the section recorded in total, including those already overwritten.
+     */
+    static uint64_t GetSampleCount(size_t section) { return GetInstance().sections[section].count.load(std::memory_order_acquire); }
+
+    /**
+     * @brief The sample with the given index in recording order, in milliseconds.
+     * Only the last HISTORY indices are still kept.
+     */
+    static float GetSample(size_t section, uint64_t index) { return GetInstance().sections[section].samples[index % HISTORY].load(std::memory_order_relaxed); }
+    static AllocationCount GetAllocationSample(size_t section, uint64_t index);
+
+    /**
+     * @brief Statistics over the section's latest samples, at most window of them.
+     */
+    static ProfileStats GetStats(size_t section, size_t window = HISTORY);
+
+    /**
+     * @brief Makes the section the one this thread's allocations are attributed to,
+     * after settling the allocations counted so far on the previous one.
+     *
+     * @return The previous section, NO_SECTION if there was none.
+     */
+    static size_t SwapCurrentSection(size_t section);
+    static size_t GetCurrentSection();
+
+    /**
+     * @brief Every allocation attributed to the section and settled so far.
+     */
+    static AllocationCount GetAllocationTotal(size_t section);
+
+private:
+    struct Section
+    {
+        std::string name;
+        ProfileDomain domain = ProfileDomain::FRAME;
+        std::array<std::atomic<float>, HISTORY> samples{};
+        std::atomic<uint64_t> count = 0;
+
+        std::atomic<uint64_t> allocationTotal = 0;
+        std::atomic<uint64_t> allocatedBytesTotal = 0;
+        std::array<std::atomic<uint32_t>, HISTORY> allocationSamples{};
+        std::array<std::atomic<uint64_t>, HISTORY> allocatedBytesSamples{};
+    };
+
+    std::array<Section, MAX_SECTIONS> sections;
+    std::atomic<size_t> sectionCount = 0;
+    std::mutex registerMutex;
+
+    Profiler() = default;
+    Profiler(const Profiler &) = delete;
+    Profiler &operator=(const Profiler &) = delete;
+
+    static Profiler &GetInstance()
+    {
+        static Profiler instance;
+        return instance;
+    }
+};
+
+/**
+ * @brief Records the time from construction to destruction into a profiler section,
+ * with the allocations made in it that no nested section claimed.
+ * While a trace is captured, the section also shows up as a zone named after it.
+ */
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(size_t section)
+        : section(section), previousSection(Profiler::SwapCurrentSection(section)),
+          startAllocations(Profiler::GetAllocationTotal(section)), start(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer()
+    {
+        auto end = std::chrono::steady_clock::now();
+        auto elapsed = end - start;
+        if (Tracer::IsRecording())
+            Tracer::RecordZone(Profiler::GetSectionName(section).c_str(), start, end);
+        Profiler::SwapCurrentSection(previousSection);
+        Profiler::Record(section, elapsed, Profiler::GetAllocationTotal(section) - startAllocations);
+    }
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+private:
+    size_t section;
+    size_t previousSection;
+    AllocationCount startAllocations;
+    std::chrono::steady_clock::time_point start;
+};
@@ -0,0 +1,77 @@
+#include "random_stream.hpp"
+
+// Multipliers and Weyl key increments of Philox4x32, from Salmon et al., "Parallel random numbers: as easy as 1, 2, 3"
+static constexpr uint32_t PHILOX_M0 = 0xD2511F53;
+static constexpr uint32_t PHILOX_M1 = 0xCD9E8D57;
+static constexpr uint32_t PHILOX_W0 = 0x9E3779B9;
+static constexpr uint32_t PHILOX_W1 = 0xBB67AE85;
+static constexpr int PHILOX_ROUNDS = 10;
+
+RandomStream::RandomStream(uint64_t seed, RandomSystem system, uint64_t entity, uint64_t tick)
+{
+    // The system goes into the key so that two systems never share a counter space.
+    // The tick keeps its low 32 bits, about two years of ticks at 60 a second
+    uint32_t systemSalt = ((uint32_t)system + 1) * PHILOX_W0;
+    key = {(uint32_t)seed, (uint32_t)(seed >> 32) ^ systemSalt};
+    counter = {0, (uint32_t)tick, (uint32_t)entity, (uint32_t)(entity >> 32)};
+}
+
+std::array<uint32_t, 4> RandomStream::Philox(std::array<uint32_t, 4> counter, std::array<uint32_t, 2> key)
+{
+    for (int round = 0; round < PHILOX_ROUNDS; ++round)
+    {
+        uint64_t product0 = (uint64_t)PHILOX_M0 * counter[0];
+        uint64_t product1 = (uint64_t)PHILOX_M1 * counter[2];
+        counter = {(uint32_t)(product1 >> 32) ^ counter[1] ^ key[0], (uint32_t)product1,
+                   (uint32_t)(product0 >> 32) ^ counter[3] ^ key[1], (uint32_t)product0};
+        key[0] += PHILOX_W0;
+        key[1] += PHILOX_W1;
+    }
+    return counter;
+}
+
+uint32_t RandomStream::NextUInt()
+{
+    if (nextInBlock == block.size())
+    {
+        block = Philox(counter, key);
+        ++counter[0];
+        nextInBlock = 0;
+    }
+    return block[nextInBlock++];
+}
+
+int RandomStream::NextInt(int min, int max)
+{
+    if (max <= min)
+        return min;
+
+    // Lemire's multiply and shift, rejecting the few values that would favour the low end of the range
+    uint64_t range = (uint64_t)((int64_t)max - min) + 1;
+    if (range > UINT32_MAX)
+        return (int)((int64_t)min + NextUInt());
+
+    uint64_t product = (uint64_t)NextUInt() * range;
+    if ((uint32_t)product < range)
+    {
+        uint32_t threshold = (uint32_t)(-(uint32_t)range % (uint32_t)range);
+        while ((uint32_t)product < threshold)
+            product = (uint64_t)NextUInt() * range;
+    }
+    return (int)((int64_t)min + (int64_t)(product >> 32));
+}
+
+double RandomStream::NextDouble()
+{
+    uint64_t bits = (uint64_t)NextUInt() << 32 | NextUInt();
+    return (double)(bits >> 11) * 0x1p-53;
+}
+
+bool RandomStream::CheckIfEventHappens(double chancePerSecond, double deltaTime)
+{
+    double expectedEvents = chancePerSecond * deltaTime;
+    if (expectedEvents >= 1.)
+        return true;
+
+    return NextDouble() < expectedEvents;
+}
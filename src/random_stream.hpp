@@ -0,0 +1,55 @@
+#pragma once
+#include "utils.hpp"
+#include <array>
+
+/**
+ * @brief Simulation systems that draw random numbers. Each gets streams independent of every other system's.
+ * Append new systems at the end, reordering changes the streams of the existing ones.
+ */
+enum class RandomSystem : uint32_t
+{
+    FIRE_SPREAD,
+};
+
+/**
+ * @brief Deterministic random numbers for the simulation, from the Philox4x32-10 counter-based generator.
+ * A stream is fully set by the world seed, the system, the entity drawing and the tick,
+ * so draws never depend on thread count, iteration order or what other entities drew.
+ * Streams are cheap to create; make one where it is needed instead of keeping it.
+ */
+class RandomStream
+{
+public:
+    RandomStream(uint64_t seed, RandomSystem system, uint64_t entity, uint64_t tick);
+    RandomStream(uint64_t seed, RandomSystem system, const Vector2Int &position, uint64_t tick)
+        : RandomStream(seed, system, (uint64_t)(uint32_t)position.x << 32 | (uint32_t)position.y, tick) {}
+
+    uint32_t NextUInt();
+
+    /**
+     * @return A uniformly distributed integer between min and max, inclusive.
+     */
+    int NextInt(int min, int max);
+
+    /**
+     * @return A uniformly distributed value in [0, 1), with 53 random bits.
+     */
+    double NextDouble();
+
+    /**
+     * @brief Determines if an event occurs based on a chance per second and delta time.
+     *
+     * @param chancePerSecond The probability of the event occurring per second.
+     * @param deltaTime The time elapsed since the last check, in seconds.
+     * @return true if the event occurs, false otherwise.
+     */
+    bool CheckIfEventHappens(double chancePerSecond, double deltaTime);
+
+private:
+    std::array<uint32_t, 2> key;
+    std::array<uint32_t, 4> counter; // The first word counts blocks, the rest hold the entity and the tick
+    std::array<uint32_t, 4> block{};
+    size_t nextInBlock = 4;
+
+    static std::array<uint32_t, 4> Philox(std::array<uint32_t, 4> counter, std::array<uint32_t, 2> key);
+};
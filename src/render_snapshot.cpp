@@ -1,19 +1,371 @@
+#include "component.hpp"
 #include "env_effect.hpp"
+#include "game_server.hpp"
 #include "pawn.hpp"
+#include "planned_task.hpp"
+#include "power_grid.hpp"
 #include "render_snapshot.hpp"
 #include "station.hpp"
 #include "tile.hpp"
 
-std::vector<std::shared_ptr<const Pawn>> RenderSnapshot::GetPawnAtPosition(const Vector2 &pos) const
+static bool ComparePositions(const Vector2Int &a, const Vector2Int &b)
 {
-    std::vector<std::shared_ptr<const Pawn>> result;
-    float radius = (PAWN_DRAW_SIZE * .5f) / TILE_SIZE;
-    float r2 = radius * radius;
-    for (const auto &kv : pawnList)
+    return a.x != b.x ? a.x < b.x : a.y < b.y;
+}
+
+TileHeight TileRender::GetHeight() const { return definition->GetHeight(); }
+const std::string &TileRender::GetId() const { return definition->GetId(); }
+
+std::string PawnRender::GetInfo() const
+{
+    std::string info = " - " + name;
+
+    if (alive)
+    {
+        info += std::format("\n   + Health: {:.1f}", health);
+        info += std::format("\n   + Oxygen: {:.0f}", oxygen);
+        info += std::format("\n   + Action: {}", actionName);
+    }
+    else
+    {
+        info += "\n   + DEAD";
+    }
+
+    return info;
+}
+
+/**
+ * Copies a tile's sprites into the flat sprite and slice arrays, and its overlay values into a TileRender.
+ */
+static TileRender CaptureTile(RenderSnapshot &snapshot, const Tile &tile, const RenderSnapshot *previous)
+{
+    TileRender render{};
+    render.definition = tile.GetTileDefinition().get();
+    render.position = tile.GetPosition();
+    if (auto rotatable = tile.GetComponent<RotatableComponent>())
+        render.rotation = RotationToAngle(rotatable->GetRotation());
+
+    // A basic sprite is a multi-slice sprite with a single full-tile slice
+    render.firstSprite = (uint32_t)snapshot.sprites.size();
+    render.spriteCount = (uint32_t)tile.GetSprites().size();
+    for (const auto &sprite : tile.GetSprites())
+    {
+        size_t firstSlice = snapshot.slices.size();
+        if (auto basic = dynamic_cast<const BasicSprite *>(sprite.get()))
+            snapshot.slices.emplace_back(Rectangle(basic->spriteOffset.x, basic->spriteOffset.y, 1, 1) * TILE_SIZE, Vector2());
+        else if (auto multiSlice = dynamic_cast<const MultiSliceSprite *>(sprite.get()))
+            std::ranges::copy_if(multiSlice->slices, std::back_inserter(snapshot.slices), [](const SpriteSlice &slice)
+                                 { return slice.sourceRect.width > 0 && slice.sourceRect.height > 0; });
+
+        Vector2Int offset = sprite ? sprite->GetOffsetFromMainTile() : Vector2Int();
+        snapshot.sprites.push_back({tile.GetPosition() + offset, (uint32_t)firstSlice, (uint32_t)(snapshot.slices.size() - firstSlice)});
+    }
+
+    TileRenderFlags flags = TileRenderFlags::NONE;
+    if (tile.HasComponent(ComponentType::SOLID))
+        flags |= TileRenderFlags::SOLID;
+    if (tile.HasComponent(ComponentType::POWER_CONSUMER) && !tile.IsActive())
+        flags |= TileRenderFlags::UNPOWERED;
+    if (auto oxygen = tile.GetComponent<OxygenComponent>())
+    {
+        flags |= TileRenderFlags::OXYGEN;
+        render.oxygen = oxygen->GetOxygenLevel();
+    }
+    if (auto door = tile.GetComponent<DoorComponent>())
+    {
+        flags |= door->IsOpen() ? TileRenderFlags::DOOR | TileRenderFlags::DOOR_OPEN : TileRenderFlags::DOOR;
+        render.doorProgress = door->GetProgress();
+        render.previousDoorProgress = render.doorProgress;
+        if (previous)
+        {
+            for (const auto &entry : previous->GetTilesAtPosition(tile.GetPosition()))
+            {
+                const auto &previousTile = previous->tiles[entry.tile];
+                if (previousTile.Has(TileRenderFlags::DOOR))
+                {
+                    render.previousDoorProgress = previousTile.doorProgress;
+                    break;
+                }
+            }
+        }
+    }
+    if (auto battery = tile.GetComponent<BatteryComponent>())
+    {
+        flags |= TileRenderFlags::BATTERY;
+        render.charge = battery->GetChargeLevel() / battery->GetMaxChargeLevel();
+    }
+    if (magic_enum::enum_flags_test_any(tile.GetHeight(), TileHeight::POWER))
+    {
+        if (auto connector = tile.GetComponent<PowerConnectorComponent>())
+        {
+            flags |= TileRenderFlags::POWER_NODE;
+            auto grid = connector->GetPowerGrid();
+            render.gridColor = grid ? grid->GetDebugColor() : Color(200, 200, 200, 128);
+        }
+    }
+    render.flags = flags;
+
+    return render;
+}
+
+static void CaptureStation(RenderSnapshot &snapshot, const Station &station, const Vector2Int &inspectPosition, const RenderSnapshot *previous,
+                           std::unordered_map<const Tile *, uint32_t> &tileIndices)
+{
+    snapshot.tiles.clear();
+    snapshot.sprites.clear();
+    snapshot.slices.clear();
+    snapshot.tilesByPosition.clear();
+
+    // Tiles covering several positions are listed at each of them, but captured once
+    for (const auto &[pos, tilesAtPos] : station.tileMap)
+    {
+        for (const auto &tile : tilesAtPos)
+        {
+            auto [it, inserted] = tileIndices.try_emplace(tile.get(), (uint32_t)snapshot.tiles.size());
+            if (inserted)
+                snapshot.tiles.push_back(CaptureTile(snapshot, *tile, previous));
+            snapshot.tilesByPosition.push_back({pos, it->second});
+        }
+    }
+    tileIndices.clear();
+    std::ranges::stable_sort(snapshot.tilesByPosition, ComparePositions, &TileAtPosition::position);
+
+    snapshot.effects.clear();
+    for (const auto &effect : station.effects)
+    {
+        if (effect)
+            snapshot.effects.push_back({effect->GetInstanceId(), effect->GetEffectDefinition().get(), effect->GetPosition(), effect->GetSize()});
+    }
+
+    snapshot.plannedTasks.resize(station.plannedTasks.size());
+    for (size_t i = 0; i < station.plannedTasks.size(); ++i)
+    {
+        const auto &task = *station.plannedTasks[i];
+        auto &render = snapshot.plannedTasks[i];
+        render.position = task.position;
+        render.tileId = task.tileId;
+        render.rotation = task.rotation;
+        render.isBuild = task.isBuild;
+    }
+    snapshot.resources = station.resources;
+
+    snapshot.navOutlines.clear();
+    snapshot.navLinks.clear();
+    for (const auto &polygon : station.navPolygons)
+    {
+        snapshot.navOutlines.push_back({polygon.vertices[0], polygon.vertices[1], polygon.vertices[2], polygon.vertices[3]});
+        for (const auto &link : polygon.links)
+            snapshot.navLinks.emplace_back(polygon.GetCenter(), station.navPolygons[link.targetPolyIdx].GetCenter());
+    }
+
+    snapshot.inspectedPosition = inspectPosition;
+    snapshot.inspectedTileInfo.clear();
+    for (const auto &tile : station.GetTilesAtPosition(inspectPosition))
+        snapshot.inspectedTileInfo.push_back(tile->GetInfo());
+    snapshot.inspectedEffectInfo.clear();
+    for (const auto &effect : station.GetEffectsAtPosition(inspectPosition))
+        snapshot.inspectedEffectInfo.push_back(effect->GetInfo());
+}
+
+static void CapturePawns(RenderSnapshot &snapshot, const PawnTable &table, const PawnGrid &grid, const RenderSnapshot *previous)
+{
+    snapshot.pawns.resize(table.Size());
+    snapshot.waypoints.clear();
+    snapshot.moveTargets.clear();
+
+    for (uint32_t slot = 0; slot < table.Size(); ++slot)
+    {
+        const Pawn &pawn = *table.pawns[slot];
+        auto &render = snapshot.pawns[slot];
+        render.id = table.ids[slot];
+        render.name = pawn.GetName();
+        render.actionName = pawn.GetActionName();
+        render.color = pawn.GetColor();
+        render.position = table.positions[slot];
+        render.previousPosition = render.position;
+        if (previous)
+        {
+            // Slots only shift when a pawn is removed, so the same slot is almost always a hit
+            if (slot < previous->pawns.size() && previous->pawns[slot].id == render.id)
+                render.previousPosition = previous->pawns[slot].position;
+            else if (auto previousSlot = previous->FindPawnSlot(render.id))
+                render.previousPosition = previous->pawns[*previousSlot].position;
+        }
+        render.facing = pawn.GetFacingDirection();
+        render.alive = table.alive[slot];
+        render.health = table.health[slot];
+        render.oxygen = table.oxygen[slot];
+
+        render.moving = false;
+        render.firstWaypoint = (uint32_t)snapshot.waypoints.size();
+        render.waypointCount = 0;
+        render.progressType = PawnProgress::NONE;
+
+        const auto &actionQueue = pawn.GetReadOnlyActionQueue();
+        if (!actionQueue.IsEmpty())
+        {
+            const auto &action = actionQueue.Front();
+            if (const auto moveAction = std::get_if<MoveAction>(&action))
+            {
+                render.moving = moveAction->IsMoving();
+                auto path = moveAction->GetRemainingPath();
+                snapshot.waypoints.insert(snapshot.waypoints.end(), path.begin(), path.end());
+                render.waypointCount = (uint32_t)path.size();
+            }
+            else if (const auto extinguishAction = std::get_if<ExtinguishAction>(&action))
+            {
+                render.progressType = PawnProgress::EXTINGUISHING;
+                render.progressPosition = extinguishAction->GetTargetPosition();
+                render.progress = extinguishAction->GetProgress();
+            }
+            else if (const auto constructionAction = std::get_if<ConstructionAction>(&action))
+            {
+                if (auto planned = constructionAction->GetPlanned().lock())
+                {
+                    float progress = std::clamp(planned->progress, 0.f, 1.f);
+                    render.progressType = PawnProgress::CONSTRUCTING;
+                    render.progressPosition = planned->position;
+                    render.progress = planned->isBuild ? progress : 1.f - progress;
+                }
+            }
+        }
+
+        render.firstMoveTarget = (uint32_t)snapshot.moveTargets.size();
+        for (size_t i = 0; i < actionQueue.Size(); ++i)
+        {
+            if (auto moveAction = std::get_if<MoveAction>(&actionQueue[i]))
+                snapshot.moveTargets.push_back(moveAction->targetPosition);
+        }
+        render.moveTargetCount = (uint32_t)(snapshot.moveTargets.size() - render.firstMoveTarget);
+    }
+
+    snapshot.pawnGrid = grid;
+}
+
+void RenderSnapshot::Capture(const GameServer &server, const Vector2Int &inspectPosition, const RenderSnapshot *previous)
+{
+    auto station = server.GetStation();
+    if (station)
+        CaptureStation(*this, *station, inspectPosition, previous, tileIndices);
+    else
+        *this = RenderSnapshot();
+    hasStation = station != nullptr;
+
+    CapturePawns(*this, server.GetPawns(), server.GetPawnGrid(), previous);
+
+    double timeScaleFactor = GetTimeScaleFactor(server.GetTimeScale());
+    tickSeconds = timeScaleFactor > 0. ? FIXED_DELTA_TIME / timeScaleFactor : 0.;
+    captureTime = std::chrono::steady_clock::now();
+}
+
+float RenderSnapshot::GetInterpolation() const
+{
+    if (tickSeconds <= 0.)
+        return 1.f;
+
+    std::chrono::duration<double> sinceCapture = std::chrono::steady_clock::now() - captureTime;
+    return (float)std::clamp(sinceCapture.count() / tickSeconds, 0., 1.);
+}
+
+template <typename T>
+static size_t GetVectorBytes(const std::vector<T> &vector)
+{
+    return vector.capacity() * sizeof(T);
+}
+
+size_t RenderSnapshot::GetMemoryUsage() const
+{
+    return sizeof(RenderSnapshot) + GetVectorBytes(tiles) + GetVectorBytes(sprites) + GetVectorBytes(slices) +
+           GetVectorBytes(tilesByPosition) + GetVectorBytes(effects) + GetVectorBytes(plannedTasks) +
+           GetVectorBytes(navOutlines) + GetVectorBytes(navLinks) + GetVectorBytes(pawns) +
+           GetVectorBytes(waypoints) + GetVectorBytes(moveTargets);
+}
+
+std::span<const TileAtPosition> RenderSnapshot::GetTilesAtPosition(const Vector2Int &pos) const
+{
+    auto range = std::ranges::equal_range(tilesByPosition, pos, ComparePositions, &TileAtPosition::position);
+    return std::span(range.begin(), range.end());
+}
+
+const TileRender *RenderSnapshot::GetTileAtPosition(const Vector2Int &pos, TileHeight height) const
+{
+    for (const auto &entry : GetTilesAtPosition(pos))
     {
-        const auto &pawn = kv.second;
-        if (pawn && Vector2DistanceSq(pos, pawn->GetPosition()) <= r2)
-            result.push_back(pawn);
+        const auto &tile = tiles[entry.tile];
+        if (height == TileHeight::NONE || magic_enum::enum_flags_test_any(tile.GetHeight(), height))
+            return &tile;
     }
+    return nullptr;
+}
+
+bool RenderSnapshot::HasPlannedTaskAt(const Vector2Int &pos) const
+{
+    return std::ranges::any_of(plannedTasks, [&pos](const PlannedTaskRender &task)
+                               { return task.position == pos; });
+}
+
+int RenderSnapshot::GetResourceCount(const std::string &resourceId) const
+{
+    auto it = resources.find(resourceId);
+    return it != resources.end() ? it->second : 0;
+}
+
+SpriteCondition RenderSnapshot::GetSpriteConditionForPosition(const Vector2Int &pos, const std::string &tileId, TileHeight height) const
+{
+    auto isSame = [&](Direction dir)
+    {
+        auto t = GetTileAtPosition(pos + DirectionToVector2Int(dir), height);
+        return t && t->GetId() == tileId;
+    };
+
+    SpriteCondition status = SpriteCondition::NONE;
+    status |= isSame(Direction::N) ? SpriteCondition::NORTH_SAME : SpriteCondition::NORTH_DIFFERENT;
+    status |= isSame(Direction::E) ? SpriteCondition::EAST_SAME : SpriteCondition::EAST_DIFFERENT;
+    status |= isSame(Direction::S) ? SpriteCondition::SOUTH_SAME : SpriteCondition::SOUTH_DIFFERENT;
+    status |= isSame(Direction::W) ? SpriteCondition::WEST_SAME : SpriteCondition::WEST_DIFFERENT;
+    status |= isSame(Direction::N | Direction::E) ? SpriteCondition::NORTH_EAST_SAME : SpriteCondition::NORTH_EAST_DIFFERENT;
+    status |= isSame(Direction::S | Direction::E) ? SpriteCondition::SOUTH_EAST_SAME : SpriteCondition::SOUTH_EAST_DIFFERENT;
+    status |= isSame(Direction::S | Direction::W) ? SpriteCondition::SOUTH_WEST_SAME : SpriteCondition::SOUTH_WEST_DIFFERENT;
+    status |= isSame(Direction::N | Direction::W) ? SpriteCondition::NORTH_WEST_SAME : SpriteCondition::NORTH_WEST_DIFFERENT;
+
+    return status;
+}
+
+std::optional<size_t> RenderSnapshot::FindPawnSlot(uint64_t id) const
+{
+    if (auto it = std::ranges::find(pawns, id, &PawnRender::id); it != pawns.end())
+        return it - pawns.begin();
+    return std::nullopt;
+}
+
+std::vector<uint32_t> RenderSnapshot::GetPawnAtPosition(const Vector2 &pos) const
+{
+    std::vector<uint32_t> result;
+    pawnGrid.QueryRadius(pos, (PAWN_DRAW_SIZE * .5f) / TILE_SIZE, result);
     return result;
 }
+
+void RenderSnapshotBuffer::Publish()
+{
+    lastPublished = back;
+    hasPublished = true;
+    back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & (FRESH - 1);
+}
+
+void RenderSnapshotBuffer::Acquire()
+{
+    if (!(middle.load(std::memory_order_relaxed) & FRESH))
+        return;
+
+    front = middle.exchange(front, std::memory_order_acq_rel) & (FRESH - 1);
+    hasFront = true;
+}
+
+void RenderSnapshotBuffer::Reset()
+{
+    middle.store(1);
+    back = 0;
+    front = 2;
+    hasFront = false;
+    hasPublished = false;
+}
@@ -1,17 +1,228 @@
 #pragma once
-#include "utils.hpp"
+#include "direction.hpp"
+#include "pawn_grid.hpp"
+#include "sprite.hpp"
+#include "tile_enums.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <span>
 #include <unordered_map>
 
-struct Pawn;
-struct Effect;
-struct Station;
+struct EffectDef;
+class GameServer;
 struct Tile;
+struct TileDef;
 
+enum class TileRenderFlags : uint8_t
+{
+    NONE = 0,
+    SOLID = 1 << 0,
+    UNPOWERED = 1 << 1,  // Power consumer that is not running
+    OXYGEN = 1 << 2,     // Holds oxygen, see TileRender::oxygen
+    DOOR = 1 << 3,       // See TileRender::doorProgress
+    DOOR_OPEN = 1 << 4,  // Fully open door
+    BATTERY = 1 << 5,    // See TileRender::charge
+    POWER_NODE = 1 << 6, // Power connector on the power layer, see TileRender::gridColor
+};
+
+template <>
+struct magic_enum::customize::enum_range<TileRenderFlags>
+{
+    static constexpr bool is_flags = true;
+};
+
+struct SpriteRender
+{
+    Vector2Int position; // Tile position plus the sprite's offset from it
+    uint32_t firstSlice;
+    uint32_t sliceCount;
+};
+
+struct TileRender
+{
+    const TileDef *definition;
+    Vector2Int position;
+    float rotation;
+    uint32_t firstSprite; // The reference sprite, extra parts follow it
+    uint32_t spriteCount;
+    TileRenderFlags flags;
+    float oxygen;
+    float doorProgress;
+    float previousDoorProgress; // As of the tick before, for interpolation
+    float charge; // Fraction of the battery's capacity
+    Color gridColor;
+
+    bool Has(TileRenderFlags flag) const { return magic_enum::enum_flags_test_any(flags, flag); }
+    TileHeight GetHeight() const;
+    const std::string &GetId() const;
+};
+
+struct TileAtPosition
+{
+    Vector2Int position;
+    uint32_t tile; // Index into RenderSnapshot::tiles
+};
+
+struct EffectRender
+{
+    uint64_t instanceId;
+    const EffectDef *definition;
+    Vector2Int position;
+    float size;
+};
+
+struct PlannedTaskRender
+{
+    Vector2Int position;
+    std::string tileId;
+    Rotation rotation;
+    bool isBuild;
+};
+
+enum class PawnProgress : uint8_t
+{
+    NONE,
+    EXTINGUISHING,
+    CONSTRUCTING,
+};
+
+struct PawnRender
+{
+    uint64_t id;
+    std::string name;
+    std::string actionName;
+    Color color;
+    Vector2 position;
+    Vector2 previousPosition; // As of the tick before, for interpolation
+    Direction facing;
+    bool alive;
+    bool moving;
+    float health;
+    float oxygen;
+
+    uint32_t firstWaypoint; // Remaining path of the current move
+    uint32_t waypointCount;
+    uint32_t firstMoveTarget; // Destinations of every queued move
+    uint32_t moveTargetCount;
+
+    PawnProgress progressType;
+    Vector2Int progressPosition;
+    float progress;
+
+    std::string GetInfo() const;
+};
+
+/**
+ * @brief Everything the renderer draws for one tick, copied out of the simulation into flat arrays.
+ * Holds no pointers into live simulation state, only into immutable definitions.
+ */
 struct RenderSnapshot
 {
-    std::unordered_map<uint64_t, std::shared_ptr<const Pawn>> pawnList;
-    std::shared_ptr<const Station> station;
-    double timeSinceFixedUpdate = 0;
+    std::vector<TileRender> tiles;
+    std::vector<SpriteRender> sprites;
+    std::vector<SpriteSlice> slices;
+    std::vector<TileAtPosition> tilesByPosition; // Sorted by position, station order within one position
+
+    std::vector<EffectRender> effects;
+    std::vector<PlannedTaskRender> plannedTasks;
+    std::unordered_map<std::string, int> resources;
+
+    std::vector<std::array<Vector2, 4>> navOutlines;
+    std::vector<std::pair<Vector2, Vector2>> navLinks; // Polygon center to linked polygon center
+
+    // Indexed by the pawn table's slots
+    std::vector<PawnRender> pawns;
+    std::vector<Vector2> waypoints;
+    std::vector<Vector2> moveTargets;
+    PawnGrid pawnGrid;
+
+    // Tooltip text for the tile the player pointed at when the tick ended
+    Vector2Int inspectedPosition;
+    std::vector<std::string> inspectedTileInfo;
+    std::vector<std::string> inspectedEffectInfo;
+
+    bool hasStation = false;
+    std::chrono::steady_clock::time_point captureTime;
+    double tickSeconds = 0; // Real time between ticks at the captured time scale, 0 when ticks are unpaced
+
+    /**
+     * @brief Refills every array from the server, reusing the memory of the previous fill.
+     *
+     * @param previous The snapshot of the tick before, source of the previous values; nullptr if there is none.
+     */
+    void Capture(const GameServer &server, const Vector2Int &inspectPosition, const RenderSnapshot *previous);
+
+    /**
+     * @brief How far the render is from the previous tick's state to this one, from 0 to 1.
+     * Drawing the blend of both lags a tick behind the simulation, but moves smoothly at any frame rate.
+     */
+    float GetInterpolation() const;
+
+    /**
+     * @brief Bytes held by the flat arrays, counting their spare capacity.
+     */
+    size_t GetMemoryUsage() const;
+
+    std::span<const TileAtPosition> GetTilesAtPosition(const Vector2Int &pos) const;
+    const TileRender *GetTileAtPosition(const Vector2Int &pos, TileHeight height = TileHeight::NONE) const;
+    bool HasPlannedTaskAt(const Vector2Int &pos) const;
+    int GetResourceCount(const std::string &resourceId) const;
+    SpriteCondition GetSpriteConditionForPosition(const Vector2Int &pos, const std::string &tileId, TileHeight height) const;
+
+    std::span<const Vector2> GetPath(const PawnRender &pawn) const { return std::span(waypoints).subspan(pawn.firstWaypoint, pawn.waypointCount); }
+    std::span<const Vector2> GetMoveTargets(const PawnRender &pawn) const { return std::span(moveTargets).subspan(pawn.firstMoveTarget, pawn.moveTargetCount); }
+    std::optional<size_t> FindPawnSlot(uint64_t id) const;
+    std::vector<uint32_t> GetPawnAtPosition(const Vector2 &pos) const;
+
+private:
+    std::unordered_map<const Tile *, uint32_t> tileIndices; // Capture scratch, emptied before Capture returns
+};
+
+/**
+ * @brief Three recycled snapshots handed from the simulation thread to the render thread without locks.
+ * The writer fills the back snapshot and swaps it into the middle, the reader swaps a newer middle
+ * to the front. Each side only ever touches its own snapshot, so neither waits on the other.
+ */
+class RenderSnapshotBuffer
+{
+public:
+    /**
+     * @brief The snapshot to fill, owned by the writer until Publish.
+     */
+    RenderSnapshot &GetBack() { return snapshots[back]; }
+    void Publish();
+
+    /**
+     * @brief The snapshot published last, for the writer to read while filling the next one.
+     * The reader never writes, and the writer does not reuse it before the next Publish.
+     */
+    const RenderSnapshot *GetLastPublished() const { return hasPublished ? &snapshots[lastPublished] : nullptr; }
+
+    /**
+     * @brief Takes the newest published snapshot as the front, if there is one.
+     * The front stays untouched by the writer until the next Acquire.
+     */
+    void Acquire();
+
+    /**
+     * @return The front snapshot, nullptr if nothing was published since the last Reset.
+     */
+    const RenderSnapshot *GetFront() const { return hasFront ? &snapshots[front] : nullptr; }
+
+    /**
+     * @brief Forgets every published snapshot. Only safe while no writer is running.
+     */
+    void Reset();
+
+private:
+    static constexpr uint8_t FRESH = 1 << 2; // Set on the middle index when it holds an unread snapshot
 
-    std::vector<std::shared_ptr<const Pawn>> GetPawnAtPosition(const Vector2 &pos) const;
+    std::array<RenderSnapshot, 3> snapshots;
+    std::atomic<uint8_t> middle = 1;
+    uint8_t back = 0;
+    uint8_t front = 2;
+    uint8_t lastPublished = 0;
+    bool hasFront = false;
+    bool hasPublished = false;
 };
@@ -0,0 +1,286 @@
+#include "component.hpp"
+#include "env_effect.hpp"
+#include "fs_utils.hpp"
+#include "game_server.hpp"
+#include "planned_task.hpp"
+#include "replay.hpp"
+#include "station.hpp"
+#include "tile.hpp"
+#include <fstream>
+#include <sstream>
+
+static std::string FormatCommand(const PlayerCommand &command)
+{
+    if (auto move = std::get_if<MovePawnCommand>(&command))
+        return std::format("move {} {} {}", move->pawnId, move->targetPosition.x, move->targetPosition.y);
+    if (auto clear = std::get_if<ClearPawnActionsCommand>(&command))
+        return std::format("clear {}", clear->pawnId);
+    if (auto plan = std::get_if<PlanTaskCommand>(&command))
+        return std::format("plan {} {} {} {} {}", plan->position.x, plan->position.y, plan->tileId, plan->isBuild ? 1 : 0, magic_enum::enum_name(plan->rotation));
+    if (auto cancel = std::get_if<CancelTaskCommand>(&command))
+        return std::format("cancel {} {}", cancel->position.x, cancel->position.y);
+    if (auto lock = std::get_if<ToggleDoorLockCommand>(&command))
+        return std::format("lock {} {}", lock->position.x, lock->position.y);
+
+    const auto &pause = std::get<PauseCommand>(command);
+    return std::format("pause {}", pause.paused.has_value() ? (*pause.paused ? "on" : "off") : "toggle");
+}
+
+static PlayerCommand ParseCommand(std::istringstream &line)
+{
+    std::string type;
+    line >> type;
+    if (type == "move")
+    {
+        MovePawnCommand move;
+        line >> move.pawnId >> move.targetPosition.x >> move.targetPosition.y;
+        return move;
+    }
+    if (type == "clear")
+    {
+        ClearPawnActionsCommand clear;
+        line >> clear.pawnId;
+        return clear;
+    }
+    if (type == "plan")
+    {
+        PlanTaskCommand plan;
+        int isBuild;
+        std::string rotation;
+        line >> plan.position.x >> plan.position.y >> plan.tileId >> isBuild >> rotation;
+        plan.isBuild = isBuild != 0;
+        plan.rotation = magic_enum::enum_cast<Rotation>(rotation).value_or(Rotation::UP);
+        return plan;
+    }
+    if (type == "cancel")
+    {
+        CancelTaskCommand cancel;
+        line >> cancel.position.x >> cancel.position.y;
+        return cancel;
+    }
+    if (type == "lock")
+    {
+        ToggleDoorLockCommand lock;
+        line >> lock.position.x >> lock.position.y;
+        return lock;
+    }
+    if (type == "pause")
+    {
+        std::string state;
+        line >> state;
+        if (state == "toggle")
+            return PauseCommand{};
+        return PauseCommand{state == "on"};
+    }
+    throw std::runtime_error(std::format("Unknown replay command: {}", type));
+}
+
+void Replay::Save(const std::string &path) const
+{
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file.is_open())
+        throw std::runtime_error(std::format("Failed to open replay file: {}", path));
+
+    file << std::format("celestium-replay {}\n", FORMAT_VERSION)
+         << std::format("seed {}\n", seed)
+         << std::format("definitions {:016x}\n", definitionsHash)
+         << std::format("ticks {}\n", tickCount)
+         << std::format("hash-interval {}\n", hashInterval)
+         << "pawns";
+    for (uint64_t id : pawnIds)
+        file << ' ' << id;
+    file << '\n';
+
+    for (const auto &recorded : commands)
+        file << std::format("command {} {}\n", recorded.tick, FormatCommand(recorded.command));
+    for (const auto &stateHash : stateHashes)
+        file << std::format("hash {} {:016x}\n", stateHash.tick, stateHash.hash);
+
+    if (!file)
+        throw std::runtime_error(std::format("Failed to write replay file: {}", path));
+}
+
+Replay Replay::Load(const std::string &path)
+{
+    std::vector<char> contents = ReadFromFile<std::vector<char>>(path);
+    std::istringstream file(std::string(contents.begin(), contents.end()));
+    Replay replay;
+    std::string text;
+    size_t lineNumber = 0;
+    while (std::getline(file, text))
+    {
+        ++lineNumber;
+        if (text.empty())
+            continue;
+
+        std::istringstream line(text);
+        std::string key;
+        line >> key;
+        if (key == "celestium-replay")
+        {
+            int version = 0;
+            line >> version;
+            if (version != FORMAT_VERSION)
+                throw std::runtime_error(std::format("Unsupported replay version {} in {}", version, path));
+        }
+        else if (key == "seed")
+            line >> replay.seed;
+        else if (key == "definitions")
+            line >> std::hex >> replay.definitionsHash;
+        else if (key == "ticks")
+            line >> replay.tickCount;
+        else if (key == "hash-interval")
+            line >> replay.hashInterval;
+        else if (key == "pawns")
+        {
+            uint64_t id;
+            while (line >> id)
+                replay.pawnIds.push_back(id);
+            line.clear();
+        }
+        else if (key == "command")
+        {
+            RecordedCommand recorded;
+            line >> recorded.tick;
+            recorded.command = ParseCommand(line);
+            replay.commands.push_back(std::move(recorded));
+        }
+        else if (key == "hash")
+        {
+            StateHash stateHash;
+            line >> stateHash.tick >> std::hex >> stateHash.hash;
+            replay.stateHashes.push_back(stateHash);
+        }
+        else
+            throw std::runtime_error(std::format("Unknown replay entry {} on line {} of {}", key, lineNumber, path));
+
+        if (line.fail())
+            throw std::runtime_error(std::format("Malformed replay line {} of {}: {}", lineNumber, path, text));
+    }
+    return replay;
+}
+
+uint64_t HashSimulationState(const GameServer &server)
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+    auto add = [&hash](const auto &value)
+    { hash = HashBytes(&value, sizeof(value), hash); };
+    auto addString = [&hash, &add](const std::string &text)
+    {
+        add(text.size());
+        hash = HashBytes(text.data(), text.size(), hash);
+    };
+
+    const auto &pawns = server.GetPawns();
+    add(pawns.Size());
+    for (uint32_t slot = 0; slot < pawns.Size(); ++slot)
+    {
+        add(pawns.positions[slot]);
+        add(pawns.health[slot]);
+        add(pawns.oxygen[slot]);
+        add(pawns.alive[slot]);
+    }
+
+    auto station = server.GetStation();
+    if (!station)
+        return hash;
+    add(station->tick);
+
+    // The tile map's own order depends on its bucket count, so positions are visited sorted
+    std::vector<Vector2Int> positions;
+    positions.reserve(station->tileMap.size());
+    for (const auto &[pos, tiles] : station->tileMap)
+        positions.push_back(pos);
+    std::ranges::sort(positions, [](const Vector2Int &a, const Vector2Int &b)
+                      { return a.x != b.x ? a.x < b.x : a.y < b.y; });
+
+    for (const auto &pos : positions)
+    {
+        add(pos);
+        for (const auto &tile : station->tileMap.at(pos))
+        {
+            addString(tile->GetId());
+            if (auto rotatable = tile->GetComponent<RotatableComponent>())
+                add(rotatable->GetRotation());
+            if (auto oxygen = tile->GetComponent<OxygenComponent>())
+                add(oxygen->GetOxygenLevel());
+            if (auto battery = tile->GetComponent<BatteryComponent>())
+                add(battery->GetChargeLevel());
+            if (auto door = tile->GetComponent<DoorComponent>())
+                add(door->GetProgress());
+            if (auto durability = tile->GetComponent<DurabilityComponent>())
+                add(durability->GetHitpoints());
+        }
+    }
+
+    add(station->effects.size());
+    for (const auto &effect : station->effects)
+    {
+        addString(effect->GetId());
+        add(effect->GetPosition());
+        add(effect->GetSize());
+    }
+
+    add(station->plannedTasks.size());
+    for (const auto &task : station->plannedTasks)
+    {
+        add(task->position);
+        addString(task->tileId);
+        add(task->isBuild);
+        add(task->progress);
+    }
+
+    std::vector<std::pair<std::string, int>> resources(station->resources.begin(), station->resources.end());
+    std::ranges::sort(resources);
+    for (const auto &[resourceId, amount] : resources)
+    {
+        addString(resourceId);
+        add(amount);
+    }
+    return hash;
+}
+
+ReplayPlayer::ReplayPlayer(const Replay &replay, const GameServer &server) : replay(replay)
+{
+    const auto &ids = server.GetPawns().ids;
+    if (ids.size() != replay.pawnIds.size())
+        throw std::runtime_error(std::format("Replay starts with {} pawns but the world has {}", replay.pawnIds.size(), ids.size()));
+
+    for (size_t i = 0; i < ids.size(); ++i)
+        pawnIds.emplace(replay.pawnIds[i], ids[i]);
+}
+
+void ReplayPlayer::QueueCommands(GameServer &server)
+{
+    auto station = server.GetStation();
+    uint64_t tick = station ? station->tick : 0;
+    for (; nextCommand < replay.commands.size() && replay.commands[nextCommand].tick <= tick; ++nextCommand)
+    {
+        PlayerCommand command = replay.commands[nextCommand].command;
+        auto remap = [this](uint64_t &pawnId)
+        {
+            if (auto it = pawnIds.find(pawnId); it != pawnIds.end())
+                pawnId = it->second;
+        };
+        if (auto move = std::get_if<MovePawnCommand>(&command))
+            remap(move->pawnId);
+        else if (auto clear = std::get_if<ClearPawnActionsCommand>(&command))
+            remap(clear->pawnId);
+
+        // More commands than the queue holds went into this tick while the game was paused, apply some early
+        while (!server.TrySendCommand(std::move(command)))
+            server.ApplyCommands();
+    }
+}
+
+bool ReplayPlayer::CheckState(const GameServer &server)
+{
+    auto station = server.GetStation();
+    uint64_t tick = station ? station->tick : 0;
+    while (nextStateHash < replay.stateHashes.size() && replay.stateHashes[nextStateHash].tick < tick)
+        ++nextStateHash;
+    if (nextStateHash == replay.stateHashes.size() || replay.stateHashes[nextStateHash].tick != tick)
+        return true;
+
+    return replay.stateHashes[nextStateHash++].hash == HashSimulationState(server);
+}
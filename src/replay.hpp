@@ -0,0 +1,85 @@
+#pragma once
+#include "player_command.hpp"
+#include <unordered_map>
+#include <vector>
+
+class GameServer;
+
+struct RecordedCommand
+{
+    uint64_t tick; // Station tick the command was applied in
+    PlayerCommand command;
+};
+
+struct StateHash
+{
+    uint64_t tick;
+    uint64_t hash;
+};
+
+/**
+ * @brief The player commands of a session, with what it takes to simulate the session again:
+ * the world seed, the definitions it ran with and the pawns it started with.
+ * Saved as a text file with one entry per line.
+ */
+struct Replay
+{
+    static constexpr int FORMAT_VERSION = 1;
+    static constexpr int DEFAULT_HASH_INTERVAL = 600;
+
+    uint64_t seed = 0;
+    uint64_t definitionsHash = 0;
+    uint64_t tickCount = 0;        // Ticks the recorded session simulated
+    int hashInterval = 0;          // Ticks between state hashes, 0 if none were taken
+    std::vector<uint64_t> pawnIds; // In slot order when recording started, commands refer to pawns by these
+    std::vector<RecordedCommand> commands;
+    std::vector<StateHash> stateHashes;
+
+    /**
+     * @brief Writes the replay to a file, replacing it. Throws if the file cannot be written.
+     */
+    void Save(const std::string &path) const;
+
+    /**
+     * @brief Reads a replay saved by Save. Throws on a missing file or a malformed line.
+     */
+    static Replay Load(const std::string &path);
+};
+
+/**
+ * @brief Hashes the state a replay must reproduce: tiles and their components, effects, pawns,
+ * planned tasks and resources. Pawns are hashed in slot order rather than by id,
+ * since ids depend on how many pawns the process created before.
+ */
+uint64_t HashSimulationState(const GameServer &server);
+
+/**
+ * @brief Feeds a replay's commands to a server ticked by the caller, and checks its state hashes.
+ * The server must hold a fresh world prepared with the replay's seed.
+ */
+class ReplayPlayer
+{
+public:
+    /**
+     * @brief Matches the recorded pawn ids to the server's pawns by slot. Throws if the pawn counts differ.
+     */
+    ReplayPlayer(const Replay &replay, const GameServer &server);
+
+    /**
+     * @brief Queues the commands recorded for the tick the server is about to run. Call before every tick.
+     */
+    void QueueCommands(GameServer &server);
+
+    /**
+     * @brief Compares the state after a tick with the recorded hash for that tick, if there is one.
+     *
+     * @return false if the state diverged from the recording.
+     */
+    bool CheckState(const GameServer &server);
+
+private:
+    const Replay &replay;
+    std::unordered_map<uint64_t, uint64_t> pawnIds; // Recorded id to the id in this server
+    size_t nextCommand = 0;
+    size_t nextStateHash = 0;
+};
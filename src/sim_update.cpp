@@ -0,0 +1,229 @@
+#include "action.hpp"
+#include "component.hpp"
+#include "env_effect.hpp"
+#include "game_server.hpp"
+#include "pawn.hpp"
+#include "power_grid.hpp"
+#include "sim_update.hpp"
+#include "station.hpp"
+#include "tile.hpp"
+#include "worker_pool.hpp"
+
+// Pawns per parallel work chunk, large enough to outweigh the hand-off cost
+constexpr size_t PAWN_CHUNK_SIZE = 64;
+
+void HandlePawnActions(GameServer &server)
+{
+    auto &pawns = server.GetPawns();
+    const size_t chunkCount = WorkerPool::GetChunkCount(pawns.Size(), PAWN_CHUNK_SIZE);
+
+    // Compute: each pawn advances its own action, shared writes are queued per chunk
+    auto &chunkWrites = server.GetSimScratch().chunkWrites;
+    auto &finished = server.GetSimScratch().finished;
+    if (chunkWrites.size() < chunkCount)
+        chunkWrites.resize(chunkCount);
+    finished.assign(pawns.Size(), 0);
+
+    WorkerPool::ParallelFor(pawns.Size(), PAWN_CHUNK_SIZE, [&pawns, &chunkWrites, &finished](size_t begin, size_t end, size_t chunk)
+                            {
+        auto &writes = chunkWrites[chunk];
+        writes.clear();
+        for (uint32_t slot = (uint32_t)begin; slot < end; ++slot)
+        {
+            auto &actionQueue = pawns.pawns[slot]->GetActionQueue();
+            if (!pawns.alive[slot] || actionQueue.IsEmpty())
+                continue;
+
+            // A new job or order wakes a reduced-rate pawn
+            pawns.SetLod(slot, SimLod::FULL);
+            PawnStep step{pawns, slot, writes};
+            finished[slot] = UpdateAction(actionQueue.Front(), step);
+        } });
+
+    // Apply: chunks are merged in order, so writes land in slot order whatever the thread count
+    if (auto station = server.GetStation())
+    {
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+        {
+            for (auto &[slot, write] : chunkWrites[chunk])
+                ApplySharedWrite(*station, write);
+            chunkWrites[chunk].clear();
+        }
+    }
+
+    // Finished actions release job claims and waypoint buffers, which are shared too
+    for (uint32_t slot = 0; slot < pawns.Size(); ++slot)
+    {
+        if (finished[slot])
+            pawns.pawns[slot]->GetActionQueue().PopFront();
+    }
+}
+
+void HandlePawnEnvironment(GameServer &server)
+{
+    auto &pawns = server.GetPawns();
+    auto station = server.GetStation();
+    pawns.BeginStep(FIXED_DELTA_TIME, station ? station->tick : 0);
+    pawns.ConsumeOxygen();
+    if (!station)
+        return;
+
+    // Look up the oxygen under every stepped pawn in parallel, the refill itself drains shared tiles
+    auto &oxygenSources = server.GetSimScratch().oxygenSources;
+    oxygenSources.resize(pawns.Size());
+    WorkerPool::ParallelFor(pawns.Size(), PAWN_CHUNK_SIZE, [&pawns, &oxygenSources](size_t begin, size_t end, size_t)
+                            {
+        for (size_t slot = begin; slot < end; ++slot)
+        {
+            auto tile = pawns.alive[slot] && pawns.stepTime[slot] > 0.f ? pawns.floors[slot].lock() : nullptr;
+            oxygenSources[slot] = tile ? tile->GetComponent<OxygenComponent>() : nullptr;
+        } });
+
+    // Apply each effect to the pawns standing on its tile, found through the pawn grid
+    auto &inFire = server.GetSimScratch().inFire;
+    auto &slotsOnTile = server.GetSimScratch().slotsOnTile;
+    inFire.assign(pawns.Size(), 0);
+    const auto &pawnGrid = server.GetPawnGrid();
+    for (const auto &effect : station->effects)
+    {
+        if (!effect)
+            continue;
+
+        const Vector2Int &effectPos = effect->GetPosition();
+        pawnGrid.QueryRect(Rectangle(effectPos.x, effectPos.y, 1, 1), slotsOnTile);
+        for (uint32_t slot : slotsOnTile)
+        {
+            if (!pawns.alive[slot] || pawns.floors[slot].expired() || ToVector2Int(pawns.positions[slot]) != effectPos)
+                continue;
+
+            // Effects run every tick for every pawn, and wake up the ones at reduced rate
+            effect->EffectPawn(pawns, slot, FIXED_DELTA_TIME);
+            pawns.SetLod(slot, SimLod::FULL);
+            if (effect->GetId() == "FIRE")
+                inFire[slot] = 1;
+        }
+    }
+
+    auto &scheduler = server.GetDecisionScheduler();
+    for (uint32_t slot = 0; slot < pawns.Size(); ++slot)
+    {
+        if (!pawns.alive[slot] || pawns.floors[slot].expired() || (pawns.stepTime[slot] <= 0.f && !inFire[slot]))
+            continue;
+
+        if (auto &oxygen = oxygenSources[slot])
+        {
+            pawns.RefillOxygen(slot, oxygen->GetOxygenLevel());
+            oxygen.reset();
+        }
+
+        PawnSituation situation = inFire[slot] ? PawnSituation::IN_FIRE : PawnSituation::NONE;
+        if (pawns.pawns[slot]->GetActionQueue().IsEmpty())
+            situation |= PawnSituation::IDLE;
+        if (pawns.oxygen[slot] < PAWN_OXYGEN_MAX * DecisionScheduler::LOW_OXYGEN_FRACTION)
+            situation |= PawnSituation::LOW_OXYGEN;
+        if (pawns.health[slot] < PAWN_HEALTH_MAX * DecisionScheduler::LOW_HEALTH_FRACTION)
+            situation |= PawnSituation::LOW_HEALTH;
+        scheduler.UpdateSituation(pawns.ids[slot], situation);
+
+        // Idle pawns breathing freely can be stepped less often, anything else needs every tick
+        bool isSettled = situation == PawnSituation::IDLE && pawns.oxygen[slot] >= PAWN_OXYGEN_MAX;
+        pawns.SetLod(slot, isSettled ? SimLod::REDUCED : SimLod::FULL);
+    }
+}
+
+void UpdatePawnCurrentTile(GameServer &server)
+{
+    auto station = server.GetStation();
+    if (!station || station->tileMap.empty())
+        return;
+
+    // Every pawn only writes its own slot, the tile map is only read
+    auto &pawns = server.GetPawns();
+    WorkerPool::ParallelFor(pawns.Size(), PAWN_CHUNK_SIZE, [&pawns, &station](size_t begin, size_t end, size_t)
+                            {
+        for (uint32_t slot = (uint32_t)begin; slot < end; ++slot)
+        {
+            if (!pawns.alive[slot])
+                continue;
+
+            Vector2Int floorPawnPos = ToVector2Int(pawns.positions[slot]);
+            if (pawns.cells[slot] == floorPawnPos && !pawns.floors[slot].expired())
+                continue;
+
+            // Changing tiles or losing the floor is a change of surroundings, step the pawn at full rate
+            pawns.cells[slot] = floorPawnPos;
+            pawns.floors[slot] = station->GetTileAtPosition(floorPawnPos, TileHeight::FLOOR);
+            pawns.SetLod(slot, SimLod::FULL);
+        } });
+}
+
+void UpdatePowerGrids(GameServer &server)
+{
+    auto station = server.GetStation();
+    if (!station)
+        return;
+
+    for (const auto &powerGrid : station->powerGrids)
+    {
+        powerGrid->Update(FIXED_DELTA_TIME);
+    }
+}
+
+/**
+ * @brief Calls function once for every tile of the station, including tiles covering several positions.
+ * A tile is always listed at its own position, so it is visited there and skipped at the others.
+ */
+template <typename Function>
+static void ForEachTile(const Station &station, Function &&function)
+{
+    for (const auto &[pos, tiles] : station.tileMap)
+    {
+        for (const auto &tile : tiles)
+        {
+            if (tile->GetPosition() == pos)
+                function(tile);
+        }
+    }
+}
+
+void AnimateDoors(GameServer &server)
+{
+    auto station = server.GetStation();
+    if (!station)
+        return;
+
+    ForEachTile(*station, [](const std::shared_ptr<Tile> &tile)
+                {
+        if (auto door = tile->GetComponent<DoorComponent>())
+            door->Animate(FIXED_DELTA_TIME); });
+}
+
+void UpdateOxygen(GameServer &server)
+{
+    auto station = server.GetStation();
+    if (!station)
+        return;
+
+    ForEachTile(*station, [](const std::shared_ptr<Tile> &tile)
+                {
+        if (auto oxygenProducer = tile->GetComponent<OxygenProducerComponent>())
+            oxygenProducer->ProduceOxygen(FIXED_DELTA_TIME);
+
+        if (auto oxygen = tile->GetComponent<OxygenComponent>())
+            oxygen->Diffuse(FIXED_DELTA_TIME); });
+}
+
+void UpdateEnvironmentalEffects(GameServer &server)
+{
+    auto station = server.GetStation();
+    if (!station)
+        return;
+
+    for (int i = station->effects.size() - 1; i >= 0; --i)
+    {
+        auto &effect = station->effects.at(i);
+        effect->Update(station, i);
+    }
+
+    station->RefreshNavHazards();
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "pawn_step.hpp"
+
+class GameServer;
+struct OxygenComponent;
+
+/**
+ * @brief Buffers the tick phases reuse between ticks, kept by each server so phases stay reentrant.
+ */
+struct SimScratch
+{
+    std::vector<SharedWriteList> chunkWrites; // Shared writes queued by each pawn chunk
+    std::vector<uint8_t> finished;            // By slot, whether the pawn's current action finished
+    std::vector<std::shared_ptr<OxygenComponent>> oxygenSources;
+    std::vector<uint8_t> inFire;       // By slot, whether the pawn stands in a fire this tick
+    std::vector<uint32_t> slotsOnTile; // Pawn grid query results
+};
+
+// Phases of a fixed tick, scheduled by GameServer::Tick through its TickGraph
+void HandlePawnActions(GameServer &server);
+void HandlePawnEnvironment(GameServer &server);
+void UpdatePawnCurrentTile(GameServer &server);
+void UpdatePowerGrids(GameServer &server);
+void AnimateDoors(GameServer &server);
+void UpdateOxygen(GameServer &server);
+void UpdateEnvironmentalEffects(GameServer &server);
@@ -76,7 +76,6 @@ public:
     Sprite(const Vector2Int &offsetFromMainTile = Vector2Int()) : offsetFromMainTile(offsetFromMainTile) {}
 
     virtual ~Sprite() = default;
-    virtual void Draw(const Vector2Int &position, const Color &tint, float rotation = 0) const = 0;
     constexpr const Vector2Int &GetOffsetFromMainTile() const { return offsetFromMainTile; }
 };
 
@@ -86,8 +85,6 @@ struct BasicSprite : public Sprite
 
     explicit BasicSprite(const Vector2Int &spriteOffset, const Vector2Int &offsetFromMainTile = Vector2Int())
         : Sprite(offsetFromMainTile), spriteOffset(spriteOffset) {}
-
-    void Draw(const Vector2Int &position, const Color &tint, float rotation = 0) const override;
 };
 
 struct MultiSliceSprite : public Sprite
@@ -96,6 +93,4 @@ struct MultiSliceSprite : public Sprite
 
     explicit MultiSliceSprite(const std::vector<SpriteSlice> &slices, const Vector2Int &offsetFromMainTile = Vector2Int())
         : Sprite(offsetFromMainTile), slices(slices) {}
-
-    void Draw(const Vector2Int &position, const Color &tint, float rotation = 0) const override;
 };
\ No newline at end of file
@@ -1,7 +1,5 @@
-#include "audio_manager.hpp"
 #include "component.hpp"
 #include "env_effect.hpp"
-#include "game_state.hpp"
 #include "planned_task.hpp"
 #include "power_grid.hpp"
 #include "sprite.hpp"
@@ -449,8 +447,10 @@ void Station::AddPlannedTask(const Vector2Int &pos, const std::string &tileId, b
     // Remove any existing plan at this position
     std::erase_if(plannedTasks, [pos](const std::shared_ptr<PlannedTask> &task)
                   { return task->position == pos; });
+    jobBoard.RemoveJob(pos);
 
     plannedTasks.push_back(std::make_shared<PlannedTask>(PlannedTask(pos, tileId, isBuild, rotation)));
+    jobBoard.AddJob(plannedTasks.back());
 }
 
 void Station::CompletePlannedTask(const Vector2Int &pos)
@@ -479,6 +479,7 @@ void Station::CompletePlannedTask(const Vector2Int &pos)
         }
     }
 
+    jobBoard.RemoveJob(pos);
     plannedTasks.erase(it);
     UpdateSpriteOffsets();
     RebuildNavigationGraph();
@@ -488,6 +489,7 @@ void Station::CancelPlannedTask(const Vector2Int &pos)
 {
     std::erase_if(plannedTasks, [pos](const std::shared_ptr<PlannedTask> &task)
                   { return task->position == pos; });
+    jobBoard.RemoveJob(pos);
 }
 
 bool Station::HasPlannedTaskAt(const Vector2Int &pos) const
@@ -717,9 +719,155 @@ void Station::RebuildNavigationGraph()
     {
         poly.RecalculateBounds();
     }
+
+    // 6. Flatten for the pathfinder and seed the dynamic link state
+    navGraph.Build(navPolygons);
+    for (auto const &[pos, tiles] : tileMap)
+    {
+        if (auto doorTile = GetTileWithComponentAtPosition(pos, ComponentType::DOOR))
+            UpdateDoorNavState(doorTile);
+    }
+
+    prevNavHazards.clear();
+    RefreshNavHazards();
+}
+
+void Station::UpdateDoorNavState(const std::shared_ptr<Tile> &doorTile)
+{
+    if (!doorTile)
+        return;
+
+    auto polyIt = tileToPoly.find(doorTile->GetPosition());
+    auto door = doorTile->GetComponent<DoorComponent>();
+    if (polyIt == tileToPoly.end() || !door)
+        return;
+
+    navGraph.SetDoorState(polyIt->second, doorTile->IsActive(), door->IsLocked(), door->IsOpen());
+}
+
+void Station::RefreshNavHazards()
+{
+    // Collect the strongest hazard per polygon, sorted by polygon index
+    navHazards.clear();
+    for (const auto &effect : effects)
+    {
+        float cost = effect->GetNavHazardCost();
+        auto polyIt = tileToPoly.find(effect->GetPosition());
+        if (cost > 0.f && polyIt != tileToPoly.end())
+            navHazards.emplace_back(polyIt->second, cost);
+    }
+    std::sort(navHazards.begin(), navHazards.end(), [](const auto &a, const auto &b)
+              { return a.first != b.first ? a.first < b.first : a.second > b.second; });
+    navHazards.erase(std::unique(navHazards.begin(), navHazards.end(), [](const auto &a, const auto &b)
+                                 { return a.first == b.first; }),
+                     navHazards.end());
+
+    // Only touch polygons whose cost actually changed
+    for (const auto &[polyIdx, cost] : navHazards)
+        navGraph.SetHazardCost(polyIdx, cost);
+    for (const auto &[polyIdx, cost] : prevNavHazards)
+    {
+        auto it = std::lower_bound(navHazards.begin(), navHazards.end(), polyIdx, [](const auto &h, int idx)
+                                   { return h.first < idx; });
+        if (it == navHazards.end() || it->first != polyIdx)
+            navGraph.SetHazardCost(polyIdx, 0.f);
+    }
+    std::swap(navHazards, prevNavHazards);
+}
+
+// Splits a room bitmap into rectangles, scanning in row-major order. Each remaining cell
+// anchors a rectangle whose height is chosen to maximize its area instead of always
+// taking the full first row. Rectangles are returned as {position, size} pairs.
+static void DecomposeBitmap(std::vector<uint8_t> cells, int width, int height, std::vector<std::pair<Vector2Int, Vector2Int>> &rects)
+{
+    // Width of the run of remaining cells starting at (x, y), capped at maxWidth
+    auto runWidth = [&](int x, int y, int maxWidth)
+    {
+        int w = 0;
+        while (w < maxWidth && x + w < width && cells[y * width + x + w])
+            ++w;
+        return w;
+    };
+
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            if (!cells[y * width + x])
+                continue;
+
+            int rowWidth = runWidth(x, y, width);
+            int bestWidth = rowWidth, bestHeight = 1;
+            for (int h = 2; y + h - 1 < height; ++h)
+            {
+                rowWidth = runWidth(x, y + h - 1, rowWidth);
+                if (rowWidth == 0)
+                    break;
+                if (rowWidth * h > bestWidth * bestHeight)
+                {
+                    bestWidth = rowWidth;
+                    bestHeight = h;
+                }
+            }
+
+            for (int row = y; row < y + bestHeight; ++row)
+                std::fill_n(cells.begin() + row * width + x, bestWidth, 0);
+
+            rects.push_back({{x, y}, {bestWidth, bestHeight}});
+        }
+    }
 }
 
 void Station::DecomposeRoom(const std::shared_ptr<Room> &room, const std::unordered_set<Vector2Int> &tiles, std::unordered_map<Vector2Int, int> &tileToPoly)
+{
+    if (tiles.empty())
+        return;
+
+    if (navDecomposition == NavDecomposition::GREEDY)
+    {
+        DecomposeRoomGreedy(room, tiles, tileToPoly);
+        return;
+    }
+
+    // Rasterize the room into a bitmap over its bounding box, plus its transpose
+    Vector2Int minPos = *tiles.begin();
+    Vector2Int maxPos = minPos;
+    for (const auto &t : tiles)
+    {
+        minPos = {std::min(minPos.x, t.x), std::min(minPos.y, t.y)};
+        maxPos = {std::max(maxPos.x, t.x), std::max(maxPos.y, t.y)};
+    }
+
+    const int width = maxPos.x - minPos.x + 1;
+    const int height = maxPos.y - minPos.y + 1;
+    std::vector<uint8_t> cells(width * height, 0);
+    std::vector<uint8_t> transposed(width * height, 0);
+    for (const auto &t : tiles)
+    {
+        Vector2Int local = t - minPos;
+        cells[local.y * width + local.x] = 1;
+        transposed[local.x * height + local.y] = 1;
+    }
+
+    // Scanning by rows favours wide rooms and by columns tall ones, keep whichever yields fewer polygons
+    std::vector<std::pair<Vector2Int, Vector2Int>> byRows, byColumns;
+    DecomposeBitmap(std::move(cells), width, height, byRows);
+    DecomposeBitmap(std::move(transposed), height, width, byColumns);
+
+    if (byColumns.size() < byRows.size())
+    {
+        for (const auto &[pos, size] : byColumns)
+            AddRoomPolygon(room, minPos + Vector2Int(pos.y, pos.x), {size.y, size.x}, tileToPoly);
+    }
+    else
+    {
+        for (const auto &[pos, size] : byRows)
+            AddRoomPolygon(room, minPos + pos, size, tileToPoly);
+    }
+}
+
+// Original greedy decomposition, kept for comparison
+void Station::DecomposeRoomGreedy(const std::shared_ptr<Room> &room, const std::unordered_set<Vector2Int> &tiles, std::unordered_map<Vector2Int, int> &tileToPoly)
 {
     auto comp = [](const Vector2Int &a, const Vector2Int &b)
     {
@@ -753,28 +901,33 @@ void Station::DecomposeRoom(const std::shared_ptr<Room> &room, const std::unorde
                 height++;
         }
 
-        int polyIdx = (int)navPolygons.size();
-        ConvexPolygon poly;
-        poly.roomId = room->id;
-        float x = (float)start.x - .5f;
-        float y = (float)start.y - .5f;
-        float w = (float)width;
-        float h = (float)height;
-
-        poly.vertices[0] = {x, y};
-        poly.vertices[1] = {x + w, y};
-        poly.vertices[2] = {x + w, y + h};
-        poly.vertices[3] = {x, y + h};
-
-        navPolygons.push_back(poly);
-        room->polygonIds.push_back(polyIdx);
-
         for (int i = 0; i < width; ++i)
             for (int j = 0; j < height; ++j)
-            {
-                Vector2Int t = start + Vector2Int(i, j);
-                remaining.erase(t);
-                tileToPoly[t] = polyIdx;
-            }
+                remaining.erase(start + Vector2Int(i, j));
+
+        AddRoomPolygon(room, start, {width, height}, tileToPoly);
     }
 }
+
+void Station::AddRoomPolygon(const std::shared_ptr<Room> &room, const Vector2Int &start, const Vector2Int &size, std::unordered_map<Vector2Int, int> &tileToPoly)
+{
+    int polyIdx = (int)navPolygons.size();
+    ConvexPolygon poly;
+    poly.roomId = room->id;
+    float x = (float)start.x - .5f;
+    float y = (float)start.y - .5f;
+    float w = (float)size.x;
+    float h = (float)size.y;
+
+    poly.vertices[0] = {x, y};
+    poly.vertices[1] = {x + w, y};
+    poly.vertices[2] = {x + w, y + h};
+    poly.vertices[3] = {x, y + h};
+
+    navPolygons.push_back(poly);
+    room->polygonIds.push_back(polyIdx);
+
+    for (int i = 0; i < size.x; ++i)
+        for (int j = 0; j < size.y; ++j)
+            tileToPoly[start + Vector2Int(i, j)] = polyIdx;
+}
@@ -1,6 +1,8 @@
 #pragma once
 #include "direction.hpp"
+#include "job_board.hpp"
 #include "navigation.hpp"
+#include "random_stream.hpp"
 #include "tile_enums.hpp"
 #include <unordered_set>
 
@@ -18,12 +20,19 @@ struct Station : public std::enable_shared_from_this<Station>
     std::vector<std::shared_ptr<Effect>> effects;
     std::vector<std::shared_ptr<PowerGrid>> powerGrids;
     std::vector<std::shared_ptr<PlannedTask>> plannedTasks;
+    JobBoard jobBoard;
     std::unordered_map<std::string, int> resources;
 
     // Navigation Graph
     std::vector<ConvexPolygon> navPolygons;
+    NavGraph navGraph;
     std::vector<std::shared_ptr<Room>> rooms;
     std::unordered_map<Vector2Int, int> tileToPoly;
+    NavDecomposition navDecomposition = NavDecomposition::MAX_RECT;
+
+    // Together they fix every random draw of the simulation, see RandomStream
+    uint64_t seed = 0;
+    uint64_t tick = 0; // Fixed ticks simulated on this station
 
 public:
     template <typename Predicate>
@@ -57,6 +66,9 @@ public:
     bool IsDoorFullyOpenAtPos(const Vector2Int &pos) const;
     std::shared_ptr<Room> GetRoomAtPosition(const Vector2Int &pos) const;
 
+    template <typename Entity>
+    RandomStream GetRandomStream(RandomSystem system, const Entity &entity) const { return RandomStream(seed, system, entity, tick); }
+
     void RemoveEffect(const std::shared_ptr<Effect> &effect);
 
     std::vector<std::shared_ptr<Effect>> GetEffectsAtPosition(const Vector2Int &pos) const;
@@ -68,6 +80,8 @@ public:
 
     void RebuildPowerGridsFromInfrastructure();
     void RebuildNavigationGraph();
+    void UpdateDoorNavState(const std::shared_ptr<Tile> &doorTile);
+    void RefreshNavHazards();
 
     void CreateRectRoom(const Vector2Int &pos, const Vector2Int &size);
     void CreateHorizontalCorridor(const Vector2Int &startPos, int length, int width);
@@ -84,7 +98,12 @@ public:
     void ReturnResourcesFromTile(const std::shared_ptr<Tile> &tile);
 
 private:
+    // Polygon hazard costs applied to navGraph, sorted by polygon index
+    std::vector<std::pair<int, float>> prevNavHazards, navHazards;
+
     void DecomposeRoom(const std::shared_ptr<Room> &room, const std::unordered_set<Vector2Int> &tiles, std::unordered_map<Vector2Int, int> &tileToPoly);
+    void DecomposeRoomGreedy(const std::shared_ptr<Room> &room, const std::unordered_set<Vector2Int> &tiles, std::unordered_map<Vector2Int, int> &tileToPoly);
+    void AddRoomPolygon(const std::shared_ptr<Room> &room, const Vector2Int &start, const Vector2Int &size, std::unordered_map<Vector2Int, int> &tileToPoly);
 };
 
 std::shared_ptr<Station> CreateStation();
\ No newline at end of file
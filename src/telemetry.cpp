@@ -0,0 +1,150 @@
+#include "game_server.hpp"
+#include "station.hpp"
+#include "telemetry.hpp"
+#include "tracer.hpp"
+
+template <typename T, typename Format>
+static void AppendJsonObject(std::string &line, const std::string &key, const std::vector<std::pair<std::string, T>> &entries, Format format)
+{
+    line += std::format(",{}:{{", QuoteJson(key));
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        if (i > 0)
+            line += ',';
+        line += QuoteJson(entries[i].first) + ':' + format(entries[i].second);
+    }
+    line += '}';
+}
+
+static std::string FormatRecord(const TelemetryRecord &record)
+{
+    std::string line = std::format("{{\"tick\":{},\"seconds\":{:.3f}", record.tick, record.seconds);
+    AppendJsonObject(line, "counts", record.counts, [](size_t count)
+                     { return std::to_string(count); });
+    AppendJsonObject(line, "sections", record.sections, [](const ProfileStats &stats)
+                     {
+                         std::string section = std::format("{{\"avg_ms\":{:.4f},\"p99_ms\":{:.4f},\"max_ms\":{:.4f}", stats.average, stats.p99, stats.max);
+                         if (Profiler::COUNTS_ALLOCATIONS)
+                             section += std::format(",\"allocs\":{:.1f},\"alloc_bytes\":{:.0f}", stats.allocations, stats.allocatedBytes);
+                         return section + "}"; });
+    AppendJsonObject(line, "gauges", record.gauges, [](double value)
+                     { return std::format("{}", value); });
+    return line + "}\n";
+}
+
+void TelemetrySink::Start(const std::string &path, int intervalTicks)
+{
+    Stop();
+
+    auto &instance = GetInstance();
+    instance.file.open(path, std::ios::out | std::ios::trunc);
+    if (!instance.file.is_open())
+        throw std::runtime_error(std::format("Failed to open telemetry file: {}", path));
+
+    instance.intervalTicks = std::max(intervalTicks, 1);
+    instance.tick = 0;
+    instance.startTime = std::chrono::steady_clock::now();
+    instance.stopping = false;
+    instance.queue.clear();
+    instance.writer = std::thread([&instance]()
+                                  { instance.WriterLoop(); });
+    instance.running = true;
+
+    TraceLog(TraceLogLevel::LOG_INFO, std::format("Writing telemetry every {} ticks to {}", instance.intervalTicks, path).c_str());
+}
+
+void TelemetrySink::Stop()
+{
+    auto &instance = GetInstance();
+    if (!instance.writer.joinable())
+        return;
+
+    instance.running = false;
+    {
+        std::lock_guard<std::mutex> lock(instance.queueMutex);
+        instance.stopping = true;
+    }
+    instance.queueCondition.notify_one();
+    instance.writer.join();
+    instance.file.close();
+}
+
+void TelemetrySink::SetGauge(const std::string &name, double value)
+{
+    auto &instance = GetInstance();
+    std::lock_guard<std::mutex> lock(instance.gaugeMutex);
+    auto it = std::ranges::find(instance.gauges, name, &std::pair<std::string, double>::first);
+    if (it != instance.gauges.end())
+        it->second = value;
+    else
+        instance.gauges.emplace_back(name, value);
+}
+
+void TelemetrySink::OnTick(const GameServer &server)
+{
+    auto &instance = GetInstance();
+    if (!instance.running.load(std::memory_order_acquire) || ++instance.tick % instance.intervalTicks != 0)
+        return;
+
+    TelemetryRecord record;
+    record.tick = instance.tick;
+    record.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - instance.startTime).count();
+
+    const auto &pawns = server.GetPawns();
+    record.counts.emplace_back("pawns", pawns.Size());
+    record.counts.emplace_back("pawns_alive", (size_t)std::ranges::count(pawns.alive, 1));
+    if (auto station = server.GetStation())
+    {
+        size_t tiles = 0;
+        for (const auto &[pos, tilesAtPos] : station->tileMap)
+            tiles += tilesAtPos.size();
+        record.counts.emplace_back("tile_positions", station->tileMap.size());
+        record.counts.emplace_back("tiles", tiles);
+        record.counts.emplace_back("effects", station->effects.size());
+        record.counts.emplace_back("power_grids", station->powerGrids.size());
+        record.counts.emplace_back("nav_polygons", station->navPolygons.size());
+        record.counts.emplace_back("rooms", station->rooms.size());
+        record.counts.emplace_back("planned_tasks", station->plannedTasks.size());
+    }
+
+    // Tick sections cover the ticks since the last record, frame sections the latest kept frames
+    for (size_t i = 0; i < Profiler::GetSectionCount(); ++i)
+    {
+        size_t window = Profiler::GetSectionDomain(i) == ProfileDomain::FRAME ? Profiler::HISTORY : (size_t)instance.intervalTicks;
+        record.sections.emplace_back(Profiler::GetSectionName(i), Profiler::GetStats(i, window));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(instance.gaugeMutex);
+        record.gauges = instance.gauges;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(instance.queueMutex);
+        instance.queue.push_back(std::move(record));
+    }
+    instance.queueCondition.notify_one();
+}
+
+void TelemetrySink::WriterLoop()
+{
+    Tracer::SetThreadName("Telemetry");
+    std::deque<TelemetryRecord> records;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this]()
+                                { return stopping || !queue.empty(); });
+            if (queue.empty())
+                return;
+            records.swap(queue);
+        }
+
+        TraceZone zone("WriteTelemetry");
+        for (const auto &record : records)
+            file << FormatRecord(record);
+        file.flush();
+        records.clear();
+    }
+}
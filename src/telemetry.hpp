@@ -0,0 +1,76 @@
+#pragma once
+#include "profiler.hpp"
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <thread>
+
+class GameServer;
+
+struct TelemetryRecord
+{
+    uint64_t tick = 0;
+    double seconds = 0; // Wall time since the sink started
+    std::vector<std::pair<std::string, size_t>> counts;
+    std::vector<std::pair<std::string, ProfileStats>> sections; // Over the ticks since the previous record, or the latest frames
+    std::vector<std::pair<std::string, double>> gauges;
+};
+
+/**
+ * @brief Appends a JSON-lines record of simulation health to a file every few ticks.
+ * The simulation thread only gathers numbers; formatting and file writes happen on the sink's own thread.
+ */
+class TelemetrySink
+{
+public:
+    /**
+     * @brief Starts writing to the file, replacing it. Throws if the file cannot be opened.
+     */
+    static void Start(const std::string &path, int intervalTicks);
+
+    /**
+     * @brief Writes the remaining records and closes the file.
+     */
+    static void Stop();
+
+    static bool IsRunning() { return GetInstance().running.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Sets a value included in every following record, for numbers the simulation does not know.
+     */
+    static void SetGauge(const std::string &name, double value);
+
+    /**
+     * @brief Counts a finished tick and queues a record when one is due. Called by the simulation after every tick.
+     */
+    static void OnTick(const GameServer &server);
+
+private:
+    std::atomic<bool> running = false;
+    int intervalTicks = 1;
+    uint64_t tick = 0;
+    std::chrono::steady_clock::time_point startTime;
+
+    std::mutex gaugeMutex;
+    std::vector<std::pair<std::string, double>> gauges;
+
+    std::thread writer;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    std::deque<TelemetryRecord> queue;
+    bool stopping = false;
+    std::ofstream file;
+
+    TelemetrySink() = default;
+    ~TelemetrySink() { Stop(); }
+    TelemetrySink(const TelemetrySink &) = delete;
+    TelemetrySink &operator=(const TelemetrySink &) = delete;
+
+    static TelemetrySink &GetInstance()
+    {
+        static TelemetrySink instance;
+        return instance;
+    }
+
+    void WriterLoop();
+};
@@ -0,0 +1,64 @@
+#include "profiler.hpp"
+#include "tick_graph.hpp"
+#include "worker_pool.hpp"
+
+/**
+ * @brief Whether running the two phases at the same time could change what either of them sees.
+ */
+static bool PhasesConflict(const TickGraph::Phase &a, const TickGraph::Phase &b)
+{
+    return magic_enum::enum_flags_test_any(a.writes, b.reads | b.writes) ||
+           magic_enum::enum_flags_test_any(b.writes, a.reads);
+}
+
+void TickGraph::AddPhase(const std::string &name, SimData reads, SimData writes, std::function<void()> run)
+{
+    Phase phase;
+    phase.name = name;
+    phase.reads = reads;
+    phase.writes = writes;
+    phase.run = std::move(run);
+    phase.profileSection = Profiler::AddSection(name, ProfileDomain::TICK_PHASE);
+    size_t index = phases.size();
+    for (size_t i = 0; i < index; ++i)
+    {
+        if (!PhasesConflict(phases[i], phase))
+            continue;
+        phases[i].successors.push_back(index);
+        ++phase.dependencyCount;
+    }
+    phases.push_back(std::move(phase));
+
+    remainingDependencies = std::make_unique<std::atomic<size_t>[]>(phases.size());
+}
+
+void TickGraph::Run()
+{
+    for (size_t i = 0; i < phases.size(); ++i)
+        remainingDependencies[i] = phases[i].dependencyCount;
+
+    JobGroup group;
+    std::function<void(size_t)> runPhase = [&](size_t index)
+    {
+        {
+            ScopedTimer timer(phases[index].profileSection);
+            phases[index].run();
+        }
+
+        // The last dependency to finish starts the successor
+        for (size_t successor : phases[index].successors)
+        {
+            if (remainingDependencies[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                group.Run([&runPhase, successor]()
+                          { runPhase(successor); });
+        }
+    };
+
+    for (size_t i = 0; i < phases.size(); ++i)
+    {
+        if (phases[i].dependencyCount == 0)
+            group.Run([&runPhase, i]()
+                      { runPhase(i); });
+    }
+    group.Wait();
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include "utils.hpp"
+#include <atomic>
+#include <functional>
+
+/**
+ * @brief Parts of the simulation state a tick phase can read or write.
+ */
+enum class SimData : uint16_t
+{
+    NONE = 0,
+    PAWNS = 1 << 0,      // Pawn table: positions, vitals, floors and step rates
+    ACTIONS = 1 << 1,    // Pawn action queues and pending player actions
+    PAWN_GRID = 1 << 2,  // Spatial index of pawn positions
+    DECISIONS = 1 << 3,  // Decision scheduler
+    TASKS = 1 << 4,      // Planned tasks and their claims
+    TILES = 1 << 5,      // Tile map and which components each tile has
+    DOORS = 1 << 6,      // Door state, including the solid component a closed door adds to its tile
+    OXYGEN = 1 << 7,     // Oxygen levels of tiles
+    POWER = 1 << 8,      // Power grids, batteries and consumer activity
+    NAV = 1 << 9,        // Navigation graph and its hazards
+    EFFECTS = 1 << 10,   // Environmental effects
+    ALL = (1 << 11) - 1,
+};
+
+template <>
+struct magic_enum::customize::enum_range<SimData>
+{
+    static constexpr bool is_flags = true;
+};
+
+/**
+ * @brief The phases of a tick, ordered by the data they read and write.
+ * Phases are declared in program order. A phase waits for every earlier phase it conflicts with,
+ * where one writes what the other reads or writes, so the result matches running them in order.
+ * Phases without a conflict run at the same time on the worker pool.
+ */
+class TickGraph
+{
+public:
+    struct Phase
+    {
+        std::string name;
+        SimData reads;
+        SimData writes;
+        std::function<void()> run;
+        std::vector<size_t> successors;
+        size_t dependencyCount = 0;
+        size_t profileSection;
+    };
+
+    /**
+     * @brief Adds a phase after every phase added so far. Its run time is profiled under its name.
+     */
+    void AddPhase(const std::string &name, SimData reads, SimData writes, std::function<void()> run);
+
+    /**
+     * @brief Runs every phase once and returns when all are done.
+     * Rethrows the first exception of a phase; phases that depend on the failed one are skipped.
+     */
+    void Run();
+
+    const std::vector<Phase> &GetPhases() const { return phases; }
+
+private:
+    std::vector<Phase> phases;
+    std::unique_ptr<std::atomic<size_t>[]> remainingDependencies;
+};
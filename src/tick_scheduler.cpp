@@ -0,0 +1,98 @@
+#include "logger.hpp"
+#include "tick_scheduler.hpp"
+#include "tracer.hpp"
+#include <thread>
+
+/**
+ * @brief Sleeps until just before the deadline, then yields until it passes.
+ */
+static void WaitUntil(TickScheduler::Clock::time_point deadline)
+{
+    if (deadline - TickScheduler::Clock::now() > TickScheduler::SPIN_WINDOW)
+        std::this_thread::sleep_until(deadline - TickScheduler::SPIN_WINDOW);
+
+    while (TickScheduler::Clock::now() < deadline)
+        std::this_thread::yield();
+}
+
+double GetTimeScaleFactor(TimeScale scale)
+{
+    switch (scale)
+    {
+    case TimeScale::NORMAL:
+        return 1.;
+    case TimeScale::DOUBLE:
+        return 2.;
+    case TimeScale::QUADRUPLE:
+        return 4.;
+    default:
+        return 0.;
+    }
+}
+
+void TickScheduler::Reset(double tickSeconds)
+{
+    tickDuration = Seconds(std::max(tickSeconds, 1e-6));
+    lag = Seconds(0.);
+    lastWake = Clock::now();
+    lastDropReport = lastWake;
+    droppedSeconds = 0.;
+    unreportedDrop = Seconds(0.);
+}
+
+void TickScheduler::Advance()
+{
+    auto now = Clock::now();
+    lag += Seconds(now - lastWake) * GetTimeScaleFactor(timeScale);
+    lastWake = now;
+}
+
+int TickScheduler::WaitForTicks()
+{
+    TraceZone zone("WaitForTicks");
+
+    // Run a full batch back to back, yielding once so threads waiting on the update lock get a turn
+    if (timeScale == TimeScale::MAX)
+    {
+        std::this_thread::yield();
+        lag = Seconds(0.);
+        lastWake = Clock::now();
+        return MAX_CATCH_UP_TICKS;
+    }
+
+    Advance();
+    if (lag < tickDuration)
+    {
+        auto realWait = std::chrono::duration_cast<Clock::duration>((tickDuration - lag) / GetTimeScaleFactor(timeScale));
+        WaitUntil(lastWake + realWait);
+        Advance();
+    }
+
+    int ticks = (int)(lag / tickDuration);
+    if (ticks > MAX_CATCH_UP_TICKS)
+    {
+        ReportDrop(tickDuration * (ticks - MAX_CATCH_UP_TICKS));
+        ticks = MAX_CATCH_UP_TICKS;
+
+        // Of the time past the capped ticks only the fraction of a tick is kept
+        lag = tickDuration * ticks + Seconds(std::fmod(lag.count(), tickDuration.count()));
+    }
+
+    lag -= tickDuration * ticks;
+    return ticks;
+}
+
+void TickScheduler::ReportDrop(const Seconds &dropped)
+{
+    droppedSeconds = droppedSeconds + dropped.count();
+    unreportedDrop += dropped;
+
+    auto now = Clock::now();
+    if (now - lastDropReport < DROP_REPORT_INTERVAL)
+        return;
+
+    ASYNC_LOG(LOG_WARNING, "Simulation is falling behind, dropped {:.0f} ms of game time ({:.2f} s in total)",
+              unreportedDrop.count() * 1000., droppedSeconds.load());
+    unreportedDrop = Seconds(0.);
+    lastDropReport = now;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include "utils.hpp"
+#include <atomic>
+#include <chrono>
+
+enum class TimeScale : uint8_t
+{
+    NORMAL,    // 1x
+    DOUBLE,    // 2x
+    QUADRUPLE, // 4x
+    MAX,       // As many ticks as the machine can run
+};
+
+/**
+ * @brief Paces fixed simulation ticks against a steady clock.
+ * Elapsed real time is scaled and accumulated; every whole tick of accumulated time is run.
+ * When the simulation falls too far behind, the excess is dropped instead of catching up,
+ * so a slow tick cannot snowball into ever longer catch-up bursts.
+ */
+class TickScheduler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using Seconds = std::chrono::duration<double>;
+
+    static constexpr int MAX_CATCH_UP_TICKS = 8;                          // Most ticks run for a single wake
+    static constexpr auto SPIN_WINDOW = std::chrono::microseconds(1000); // The end of a wait is spun, sleeping overshoots by about this much
+    static constexpr auto DROP_REPORT_INTERVAL = std::chrono::seconds(1);
+
+    /**
+     * @brief Restarts timing from now with nothing accumulated or dropped.
+     */
+    void Reset(double tickSeconds);
+
+    /**
+     * @brief Restarts timing from now, keeping the accumulated time. Used when resuming from pause.
+     */
+    void Resync() { lastWake = Clock::now(); }
+
+    void SetTimeScale(TimeScale scale) { timeScale = scale; }
+    TimeScale GetTimeScale() const { return timeScale; }
+
+    /**
+     * @brief Waits until at least one tick is due and takes the due ticks off the accumulated time.
+     *
+     * @return How many ticks to run now, at most MAX_CATCH_UP_TICKS.
+     */
+    int WaitForTicks();
+
+    /**
+     * @brief Simulation time accumulated but not yet simulated, in seconds.
+     */
+    double GetLag() const { return lag.count(); }
+
+    /**
+     * @brief Simulation time skipped because the ticks could not keep up, in seconds.
+     */
+    double GetDroppedTime() const { return droppedSeconds; }
+
+private:
+    Seconds tickDuration = Seconds(1.);
+    Seconds lag = Seconds(0.);
+    Clock::time_point lastWake;
+    std::atomic<TimeScale> timeScale = TimeScale::NORMAL;
+
+    std::atomic<double> droppedSeconds = 0.;
+    Seconds unreportedDrop = Seconds(0.);
+    Clock::time_point lastDropReport;
+
+    void Advance();
+    void ReportDrop(const Seconds &dropped);
+};
+
+/**
+ * @return The number of simulated seconds per real second, or 0 for TimeScale::MAX.
+ */
+double GetTimeScaleFactor(TimeScale scale);
@@ -1,40 +1,9 @@
-#include "asset_manager.hpp"
-#include "camera.hpp"
 #include "component.hpp"
 #include "def_manager.hpp"
-#include "game_state.hpp"
 #include "power_grid.hpp"
-#include "sprite.hpp"
 #include "station.hpp"
 #include "tile.hpp"
 
-void BasicSprite::Draw(const Vector2Int &position, const Color &tint, float rotation) const
-{
-    Vector2 screenPos = GameManager::WorldToScreen(position + offsetFromMainTile);
-    Vector2 tileSize = Vector2(1, 1) * TILE_SIZE * GameManager::GetCamera().GetZoom();
-    Rectangle sourceRect = Rectangle(spriteOffset.x, spriteOffset.y, 1, 1) * TILE_SIZE;
-
-    DrawTexturePro(AssetManager::GetTexture("STATION"), sourceRect, Vector2ToRect(screenPos, tileSize), tileSize / 2., rotation, tint);
-}
-
-void MultiSliceSprite::Draw(const Vector2Int &position, const Color &tint, float rotation) const
-{
-    Vector2 screenPos = GameManager::WorldToScreen(position + offsetFromMainTile);
-
-    for (const auto &slice : slices)
-    {
-        if (slice.sourceRect.width <= 0 || slice.sourceRect.height <= 0)
-            continue;
-
-        Rectangle destRect = Vector2ToRect(slice.destOffset, RectToSize(slice.sourceRect)) * GameManager::GetCamera().GetZoom();
-        Vector2 tileSize = Vector2(1, 1) * TILE_SIZE * GameManager::GetCamera().GetZoom();
-        destRect.x += screenPos.x;
-        destRect.y += screenPos.y;
-
-        DrawTexturePro(AssetManager::GetTexture("STATION"), slice.sourceRect, destRect, tileSize / 2., rotation, tint);
-    }
-}
-
 Tile::Tile(const std::string &tileId, const Vector2Int &position, const std::shared_ptr<Station> &station)
     : tileDef(DefinitionManager::GetTileDefinition(tileId)), position(position), station(station) {}
 
@@ -0,0 +1,130 @@
+#include "tracer.hpp"
+
+thread_local Tracer::ThreadBuffer *Tracer::currentBuffer = nullptr;
+
+void Tracer::Start(const std::string &path, size_t eventsPerThread)
+{
+    Stop();
+
+    auto &instance = GetInstance();
+    std::lock_guard<std::mutex> lock(instance.buffersMutex);
+    instance.file.open(path, std::ios::out | std::ios::trunc);
+    if (!instance.file.is_open())
+        throw std::runtime_error(std::format("Failed to open trace file: {}", path));
+
+    for (auto &buffer : instance.buffers)
+    {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        buffer->events.clear();
+        buffer->written = 0;
+    }
+
+    instance.path = path;
+    instance.eventsPerThread = std::max<size_t>(eventsPerThread, 1);
+    instance.startTime = std::chrono::steady_clock::now();
+    instance.recording.store(true, std::memory_order_release);
+
+    TraceLog(TraceLogLevel::LOG_INFO, std::format("Tracing until stopped, keeping the last {} events per thread", instance.eventsPerThread).c_str());
+}
+
+void Tracer::Stop()
+{
+    auto &instance = GetInstance();
+    if (!instance.recording.exchange(false, std::memory_order_acq_rel))
+        return;
+
+    std::lock_guard<std::mutex> lock(instance.buffersMutex);
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    json += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Celestium\"}}";
+
+    auto toMicroseconds = [&instance](std::chrono::steady_clock::time_point time)
+    { return std::max(std::chrono::duration<double, std::micro>(time - instance.startTime).count(), 0.); };
+
+    size_t eventCount = 0;
+    uint64_t overwritten = 0;
+    for (auto &buffer : instance.buffers)
+    {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        std::string threadName = buffer->threadName.empty() ? std::format("Thread {}", buffer->threadId) : buffer->threadName;
+        json += std::format(",\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":{}}}}}", buffer->threadId, QuoteJson(threadName));
+        json += std::format(",\n{{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"sort_index\":{}}}}}", buffer->threadId, buffer->threadId);
+
+        uint64_t kept = std::min<uint64_t>(buffer->written, buffer->events.size());
+        overwritten += buffer->written - kept;
+        for (uint64_t i = buffer->written - kept; i < buffer->written; ++i)
+        {
+            const auto &event = buffer->events[i % buffer->events.size()];
+            if (event.isCounter)
+                json += std::format(",\n{{\"name\":{},\"ph\":\"C\",\"ts\":{:.3f},\"pid\":1,\"tid\":{},\"args\":{{\"value\":{}}}}}",
+                                    QuoteJson(event.name), toMicroseconds(event.start), buffer->threadId, event.value);
+            else
+                json += std::format(",\n{{\"name\":{},\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":1,\"tid\":{}}}",
+                                    QuoteJson(event.name), toMicroseconds(event.start),
+                                    std::chrono::duration<double, std::micro>(event.duration).count(), buffer->threadId);
+        }
+        eventCount += kept;
+
+        // Released until the next capture, which allocates again on each thread's first event
+        buffer->events = std::vector<TraceEvent>();
+        buffer->written = 0;
+    }
+    json += "\n]}\n";
+
+    instance.file << json;
+    instance.file.close();
+    if (instance.file.fail())
+    {
+        TraceLog(TraceLogLevel::LOG_ERROR, std::format("Failed to write trace file: {}", instance.path).c_str());
+        return;
+    }
+
+    TraceLog(TraceLogLevel::LOG_INFO, std::format("Wrote {} trace events to {}", eventCount, instance.path).c_str());
+    if (overwritten > 0)
+        TraceLog(TraceLogLevel::LOG_WARNING, std::format("Trace rings wrapped, the oldest {} events were dropped", overwritten).c_str());
+}
+
+Tracer::ThreadBuffer &Tracer::GetThreadBuffer()
+{
+    if (currentBuffer)
+        return *currentBuffer;
+
+    auto &instance = GetInstance();
+    std::lock_guard<std::mutex> lock(instance.buffersMutex);
+    auto &buffer = instance.buffers.emplace_back(std::make_unique<ThreadBuffer>());
+    buffer->threadId = (uint32_t)instance.buffers.size();
+    currentBuffer = buffer.get();
+    return *buffer;
+}
+
+void Tracer::SetThreadName(const std::string &name)
+{
+    auto &buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.threadName = name;
+}
+
+void Tracer::RecordZone(const char *name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+{
+    Record({.name = name, .start = start, .duration = end - start});
+}
+
+void Tracer::RecordCounter(const char *name, double value)
+{
+    if (IsRecording())
+        Record({.name = name, .start = std::chrono::steady_clock::now(), .value = value, .isCounter = true});
+}
+
+void Tracer::Record(const TraceEvent &event)
+{
+    auto &instance = GetInstance();
+    auto &buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+
+    // Checked again under the lock, a capture that stopped meanwhile has already been written
+    if (!instance.recording.load(std::memory_order_acquire))
+        return;
+
+    if (buffer.events.empty())
+        buffer.events.resize(instance.eventsPerThread);
+    buffer.events[buffer.written++ % buffer.events.size()] = event;
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include "utils.hpp"
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+struct TraceEvent
+{
+    const char *name = nullptr; // Must outlive the capture, string literals and profiler section names do
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::duration duration{}; // Zones only
+    double value = 0;                               // Counters only
+    bool isCounter = false;
+};
+
+/**
+ * @brief Records zones and counters of every thread onto one timeline and writes them
+ * as a Chrome trace-event JSON file, which opens in Perfetto and chrome://tracing.
+ *
+ * Each thread writes into its own ring of events, so a capture keeps the latest events of every thread.
+ * Zones are recorded whole when they end, so a ring that wrapped never leaves a zone half open.
+ * While no capture runs, recording costs one relaxed load.
+ */
+class Tracer
+{
+public:
+    static constexpr size_t DEFAULT_EVENTS_PER_THREAD = 1 << 16;
+
+    /**
+     * @brief Starts a capture, dropping the events of the previous one.
+     * The file is opened here and written by Stop. Throws if it cannot be opened.
+     */
+    static void Start(const std::string &path, size_t eventsPerThread = DEFAULT_EVENTS_PER_THREAD);
+
+    /**
+     * @brief Ends the capture and writes it out.
+     */
+    static void Stop();
+
+    static bool IsRecording() { return GetInstance().recording.load(std::memory_order_relaxed); }
+    static const std::string &GetPath() { return GetInstance().path; }
+
+    /**
+     * @brief Names the calling thread on the timeline. Threads left unnamed show up by number.
+     */
+    static void SetThreadName(const std::string &name);
+
+    static void RecordZone(const char *name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+    static void RecordCounter(const char *name, double value);
+
+private:
+    struct ThreadBuffer
+    {
+        std::mutex mutex; // Only contended while a capture starts or is written
+        uint32_t threadId = 0;
+        std::string threadName;
+        std::vector<TraceEvent> events;
+        uint64_t written = 0; // Events since the capture started, the ring keeps the last events.size()
+    };
+
+    std::atomic<bool> recording = false;
+    std::string path;
+    std::ofstream file; // Open for the whole capture
+    size_t eventsPerThread = DEFAULT_EVENTS_PER_THREAD;
+    std::chrono::steady_clock::time_point startTime;
+
+    // Buffers live as long as the tracer, so a thread that exits keeps its events until they are written
+    std::mutex buffersMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    static thread_local ThreadBuffer *currentBuffer; // Registered on the thread's first event or name
+
+    Tracer() = default;
+    Tracer(const Tracer &) = delete;
+    Tracer &operator=(const Tracer &) = delete;
+
+    static Tracer &GetInstance()
+    {
+        static Tracer instance;
+        return instance;
+    }
+
+    static ThreadBuffer &GetThreadBuffer();
+    static void Record(const TraceEvent &event);
+};
+
+/**
+ * @brief Records the time from construction to destruction as a zone, if a capture is running.
+ */
+class TraceZone
+{
+public:
+    explicit TraceZone(const char *name) : name(name)
+    {
+        if (Tracer::IsRecording())
+            start = std::chrono::steady_clock::now();
+    }
+    ~TraceZone()
+    {
+        if (Tracer::IsRecording() && start != std::chrono::steady_clock::time_point())
+            Tracer::RecordZone(name, start, std::chrono::steady_clock::now());
+    }
+    TraceZone(const TraceZone &) = delete;
+    TraceZone &operator=(const TraceZone &) = delete;
+
+private:
+    const char *name;
+    std::chrono::steady_clock::time_point start;
+};
@@ -1,21 +1,17 @@
-#include "action.hpp"
 #include "asset_manager.hpp"
 #include "camera.hpp"
 #include "component.hpp"
 #include "def_manager.hpp"
-#include "env_effect.hpp"
 #include "game_server.hpp"
 #include "game_state.hpp"
+#include "logger.hpp"
 #include "lua_bindings.hpp"
 #include "particle_system.hpp"
 #include "pawn_def.hpp"
-#include "pawn.hpp"
-#include "planned_task.hpp"
-#include "power_grid.hpp"
+#include "profiler.hpp"
 #include "render_snapshot.hpp"
 #include "sprite.hpp"
-#include "station.hpp"
-#include "tile.hpp"
+#include "tile_def.hpp"
 #include "ui_manager.hpp"
 #include "ui.hpp"
 
@@ -26,7 +22,7 @@ struct RenderParticleSystem
     sol::protected_function onCreateFunc;
     sol::protected_function onUpdateFunc;
     sol::protected_function onDeleteFunc;
-    std::shared_ptr<Effect> effectRef;
+    std::shared_ptr<EffectRender> effectRef; // Refreshed from the snapshot every frame while the effect exists
     bool deleteCalled = false;
 };
 
@@ -38,9 +34,10 @@ struct StarfieldParticle
 };
 
 std::unordered_map<uint64_t, std::vector<RenderParticleSystem>> g_renderSystems;
+std::unordered_map<uint64_t, float> g_pawnAnimationTimes;
 std::vector<StarfieldParticle> g_starfieldParticles;
 
-Color GetTileTint(const std::shared_ptr<Tile> &)
+Color GetTileTint(const TileRender &)
 {
     Color tint = WHITE;
     // if (GameManager::IsInBuildMode() && GameManager::IsTileSelected(tile))
@@ -51,6 +48,52 @@ Color GetTileTint(const std::shared_ptr<Tile> &)
     return tint;
 }
 
+/**
+ * Draws slices of the station tileset, placed relative to the given tile position.
+ */
+static void DrawSpriteSlices(std::span<const SpriteSlice> slices, const Vector2Int &position, const Color &tint, float rotation)
+{
+    Vector2 screenPos = GameManager::WorldToScreen(position);
+    Vector2 tileSize = Vector2(1, 1) * TILE_SIZE * GameManager::GetCamera().GetZoom();
+    Texture2D stationTileset = AssetManager::GetTexture("STATION");
+
+    for (const auto &slice : slices)
+    {
+        if (slice.sourceRect.width <= 0 || slice.sourceRect.height <= 0)
+            continue;
+
+        Rectangle destRect = Vector2ToRect(slice.destOffset, RectToSize(slice.sourceRect)) * GameManager::GetCamera().GetZoom();
+        destRect.x += screenPos.x;
+        destRect.y += screenPos.y;
+
+        DrawTexturePro(stationTileset, slice.sourceRect, destRect, tileSize / 2., rotation, tint);
+    }
+}
+
+/**
+ * Draws a tile sprite from the station tileset, at its offset from the tile's main position.
+ */
+void DrawSprite(const Sprite &sprite, const Vector2Int &position, const Color &tint, float rotation)
+{
+    Vector2Int spritePos = position + sprite.GetOffsetFromMainTile();
+
+    if (auto basic = dynamic_cast<const BasicSprite *>(&sprite))
+    {
+        SpriteSlice slice(Rectangle(basic->spriteOffset.x, basic->spriteOffset.y, 1, 1) * TILE_SIZE, Vector2());
+        DrawSpriteSlices(std::span(&slice, 1), spritePos, tint, rotation);
+    }
+    else if (auto multiSlice = dynamic_cast<const MultiSliceSprite *>(&sprite))
+        DrawSpriteSlices(multiSlice->slices, spritePos, tint, rotation);
+}
+
+/**
+ * Draws one of the sprites captured into a render snapshot.
+ */
+static void DrawSpriteRender(const RenderSnapshot &snapshot, const SpriteRender &sprite, const Color &tint, float rotation)
+{
+    DrawSpriteSlices(std::span(snapshot.slices).subspan(sprite.firstSlice, sprite.sliceCount), sprite.position, tint, rotation);
+}
+
 void DrawDoorPanels(const Vector2Int &pos, float progress, float rotation, const Color &tint)
 {
     float zoom = GameManager::GetCamera().GetZoom();
@@ -69,22 +112,22 @@ void DrawDoorPanels(const Vector2Int &pos, float progress, float rotation, const
     DrawTexturePro(stationTileset, doorSourceRect2, destRect, pivot, rotation + 180.f, tint);
 }
 
-void DrawSpriteDefGhost(const std::shared_ptr<SpriteDef> &spriteDef, const Vector2Int &pos, const Color &tint, float rotation, const std::shared_ptr<const Station> &station, const std::string &tileId, TileHeight height)
+void DrawSpriteDefGhost(const std::shared_ptr<SpriteDef> &spriteDef, const Vector2Int &pos, const Color &tint, float rotation, const RenderSnapshot *snapshot, const std::string &tileId, TileHeight height)
 {
     if (auto basicDef = std::dynamic_pointer_cast<BasicSpriteDef>(spriteDef))
-        BasicSprite(basicDef->spriteOffset).Draw(pos, tint, rotation);
+        DrawSprite(BasicSprite(basicDef->spriteOffset), pos, tint, rotation);
     else if (auto multiDef = std::dynamic_pointer_cast<MultiSliceSpriteDef>(spriteDef))
     {
-        auto status = station ? station->GetSpriteConditionForPosition(pos, tileId, height) : SpriteCondition::NONE;
+        auto status = snapshot && snapshot->hasStation ? snapshot->GetSpriteConditionForPosition(pos, tileId, height) : SpriteCondition::NONE;
         std::vector<SpriteSlice> slices;
         for (const auto &swc : multiDef->slices)
             if ((status & swc.conditions) == swc.conditions)
                 slices.push_back(swc.slice);
-        MultiSliceSprite(slices).Draw(pos, tint, rotation);
+        DrawSprite(MultiSliceSprite(slices), pos, tint, rotation);
     }
 }
 
-void DrawTileDefGhost(const std::shared_ptr<TileDef> &tileDef, const Vector2Int &pos, const Color &tint, float rotation, const std::shared_ptr<const Station> &station)
+void DrawTileDefGhost(const std::shared_ptr<TileDef> &tileDef, const Vector2Int &pos, const Color &tint, float rotation, const RenderSnapshot *snapshot)
 {
     if (!tileDef)
         return;
@@ -92,9 +135,9 @@ void DrawTileDefGhost(const std::shared_ptr<TileDef> &tileDef, const Vector2Int
     const std::string &tileId = tileDef->GetId();
     TileHeight height = tileDef->GetHeight();
 
-    DrawSpriteDefGhost(tileDef->GetReferenceSprite(), pos, tint, rotation, station, tileId, height);
+    DrawSpriteDefGhost(tileDef->GetReferenceSprite(), pos, tint, rotation, snapshot, tileId, height);
     for (const auto &cell : tileDef->GetExtraParts())
-        DrawSpriteDefGhost(cell.spriteDef, pos + OffsetWithRotation(rotEnum, cell.offset), tint, rotation, station, tileId, height);
+        DrawSpriteDefGhost(cell.spriteDef, pos + OffsetWithRotation(rotEnum, cell.offset), tint, rotation, snapshot, tileId, height);
     if (tileDef->HasComponent(ComponentType::DOOR))
         DrawDoorPanels(pos, 1.f, rotation, tint);
 }
@@ -128,10 +171,10 @@ void DrawTileGrid()
 /**
  * Draws a path as a series of lines between waypoints.
  *
- * @param path     A queue of Vector2Int positions representing the path to draw.
+ * @param path     The remaining waypoints of the path to draw.
  * @param startPos The starting position of the path.
  */
-void DrawPath(const std::deque<Vector2> &path, const Vector2 &startPos)
+void DrawPath(std::span<const Vector2> path, const Vector2 &startPos)
 {
     if (path.empty())
         return;
@@ -144,127 +187,89 @@ void DrawPath(const std::deque<Vector2> &path, const Vector2 &startPos)
     }
 }
 
-static std::vector<std::shared_ptr<Tile>> GetUniqueTiles(const std::shared_ptr<const Station> &station)
-{
-    std::vector<std::shared_ptr<Tile>> tiles;
-    if (!station)
-        return tiles;
-    std::unordered_set<std::shared_ptr<Tile>> uniqueTiles;
-    for (const auto &kv : station->tileMap)
-        for (const auto &tile : kv.second)
-            if (uniqueTiles.insert(tile).second)
-                tiles.push_back(tile);
-    return tiles;
-}
-
 /**
  * Draws the station tiles and direct overlays.
  */
 void DrawStationTiles()
 {
+    static const size_t profileSection = Profiler::AddSection("DrawStationTiles", ProfileDomain::FRAME);
+    ScopedTimer timer(profileSection);
+
     auto snapshot = GameManager::GetRenderSnapshot();
-    if (!snapshot || !snapshot->station)
+    if (!snapshot || !snapshot->hasStation)
         return;
 
     auto &camera = GameManager::GetCamera();
     const float zoom = camera.GetZoom();
     const Vector2 tileSize = Vector2(1, 1) * TILE_SIZE * zoom;
 
-    auto tiles = GetUniqueTiles(snapshot->station);
-
     // Pass 1: Draw main/reference sprites for all tiles
-    for (const auto &tile : tiles)
+    for (const auto &tile : snapshot->tiles)
     {
-        float rotation = 0;
-        if (auto rotatable = tile->GetComponent<RotatableComponent>())
-            rotation = RotationToAngle(rotatable->GetRotation());
-
-        Color tint = GetTileTint(tile);
-        if (!tile->GetSprites().empty() && tile->GetSprites().front())
-            tile->GetSprites().front()->Draw(tile->GetPosition(), tint, rotation);
+        if (tile.spriteCount > 0)
+            DrawSpriteRender(*snapshot, snapshot->sprites[tile.firstSprite], GetTileTint(tile), tile.rotation);
     }
 
     // Pass 2: Draw extra parts / offset sprites for all tiles
-    for (const auto &tile : tiles)
+    for (const auto &tile : snapshot->tiles)
     {
-        float rotation = 0;
-        if (auto rotatable = tile->GetComponent<RotatableComponent>())
-            rotation = RotationToAngle(rotatable->GetRotation());
-
         Color tint = GetTileTint(tile);
-        const auto &sprites = tile->GetSprites();
-        for (size_t i = 1; i < sprites.size(); ++i)
-        {
-            if (sprites[i])
-                sprites[i]->Draw(tile->GetPosition(), tint, rotation);
-        }
+        for (uint32_t i = 1; i < tile.spriteCount; ++i)
+            DrawSpriteRender(*snapshot, snapshot->sprites[tile.firstSprite + i], tint, tile.rotation);
     }
 
     // Pass 3: Draw oxygen and wall debug overlays
-    for (const auto &tile : tiles)
+    for (const auto &tile : snapshot->tiles)
     {
-        Vector2 startPos = GameManager::WorldToScreen(ToVector2(tile->GetPosition()) - Vector2(.5f, .5f));
+        Vector2 startPos = GameManager::WorldToScreen(ToVector2(tile.position) - Vector2(.5f, .5f));
 
-        if (camera.IsOverlay(PlayerCam::Overlay::OXYGEN))
+        if (camera.IsOverlay(PlayerCam::Overlay::OXYGEN) && tile.Has(TileRenderFlags::OXYGEN))
         {
-            if (auto oxygen = tile->GetComponent<OxygenComponent>())
-            {
-                Color color = Color(50, 150, 255, oxygen->GetOxygenLevel() / TILE_OXYGEN_MAX * 255 * .8f);
-                DrawRectangleV(startPos, tileSize, color);
-            }
+            Color color = Color(50, 150, 255, tile.oxygen / TILE_OXYGEN_MAX * 255 * .8f);
+            DrawRectangleV(startPos, tileSize, color);
         }
 
-        if (camera.IsOverlay(PlayerCam::Overlay::WALL) && tile->HasComponent(ComponentType::SOLID))
+        if (camera.IsOverlay(PlayerCam::Overlay::WALL) && tile.Has(TileRenderFlags::SOLID))
             DrawRectangleV(startPos, tileSize, Color(255, 0, 0, 64));
     }
 }
 
 void DrawStationOverlays()
 {
+    static const size_t profileSection = Profiler::AddSection("DrawStationOverlays", ProfileDomain::FRAME);
+    ScopedTimer timer(profileSection);
+
     auto snapshot = GameManager::GetRenderSnapshot();
-    if (!snapshot || !snapshot->station)
+    if (!snapshot || !snapshot->hasStation)
         return;
 
     float zoom = GameManager::GetCamera().GetZoom();
     const Vector2 tileSize = Vector2(1, 1) * TILE_SIZE * zoom;
     bool isPowerOverlay = GameManager::GetCamera().IsOverlay(PlayerCam::Overlay::POWER);
+    const float interpolation = snapshot->GetInterpolation();
     Texture2D iconTileset = AssetManager::GetTexture("ICON");
 
-    auto tiles = GetUniqueTiles(snapshot->station);
-
-    for (const auto &tile : tiles)
+    for (const auto &tile : snapshot->tiles)
     {
-        Color tint = GetTileTint(tile);
-        float rotation = 0;
-        if (auto rotatable = tile->GetComponent<RotatableComponent>())
-            rotation = RotationToAngle(rotatable->GetRotation());
+        if (tile.Has(TileRenderFlags::DOOR))
+            DrawDoorPanels(tile.position, std::lerp(tile.previousDoorProgress, tile.doorProgress, interpolation), tile.rotation, GetTileTint(tile));
 
-        if (auto door = tile->GetComponent<DoorComponent>())
-            DrawDoorPanels(tile->GetPosition(), door->GetProgress(), rotation, tint);
+        if (isPowerOverlay && tile.Has(TileRenderFlags::POWER_NODE))
+            DrawCircleV(GameManager::WorldToScreen(ToVector2(tile.position)), 3.f * zoom, tile.gridColor);
 
-        if (isPowerOverlay && magic_enum::enum_flags_test_any(tile->GetHeight(), TileHeight::POWER))
+        if (tile.Has(TileRenderFlags::UNPOWERED))
         {
-            if (auto connector = tile->GetComponent<PowerConnectorComponent>())
-            {
-                auto grid = connector->GetPowerGrid();
-                Color gridColor = grid ? grid->GetDebugColor() : Color(200, 200, 200, 128);
-                DrawCircleV(GameManager::WorldToScreen(ToVector2(tile->GetPosition())), 3.f * zoom, gridColor);
-            }
-        }
-
-        if (tile->HasComponent(ComponentType::POWER_CONSUMER) && !tile->IsActive())
-        {
-            Vector2 startScreenPos = GameManager::WorldToScreen(ToVector2(tile->GetPosition()) + Vector2(2. / 3., 0));
+            Vector2 startScreenPos = GameManager::WorldToScreen(ToVector2(tile.position) + Vector2(2. / 3., 0));
             Rectangle destRect = Vector2ToRect(startScreenPos, tileSize / 3.);
             Rectangle sourceRect = Rectangle(0, 1, 1, 1) * TILE_SIZE;
             DrawTexturePro(iconTileset, sourceRect, destRect, tileSize / 2., 0, Fade(YELLOW, .8));
         }
 
-        if (auto battery = tile->GetComponent<BatteryComponent>())
+        if (tile.Has(TileRenderFlags::BATTERY))
         {
-            float barProgress = battery->GetChargeLevel() / battery->GetMaxChargeLevel();
-            Vector2 topLeftPos = GameManager::WorldToScreen(ToVector2(tile->GetPosition()) - Vector2(.5 - 1. / 16., .5));
-            Vector2 barStartPos = GameManager::WorldToScreen(ToVector2(tile->GetPosition()) - Vector2(.5 - 1. / 16., barProgress - .5));
+            float barProgress = tile.charge;
+            Vector2 topLeftPos = GameManager::WorldToScreen(ToVector2(tile.position) - Vector2(.5 - 1. / 16., .5));
+            Vector2 barStartPos = GameManager::WorldToScreen(ToVector2(tile.position) - Vector2(.5 - 1. / 16., barProgress - .5));
             Vector2 totalSize = Vector2(1. / 8., 1) * TILE_SIZE * zoom;
             Vector2 barSize = Vector2(1. / 8., barProgress) * TILE_SIZE * zoom;
             DrawRectangleV(topLeftPos, totalSize, Color(25, 25, 25, 200));
@@ -273,24 +278,16 @@ void DrawStationOverlays()
     }
 
     // Draw NavMesh debug outlines
-    for (int pIdx = 0; pIdx < (int)snapshot->station->navPolygons.size(); ++pIdx)
+    for (const auto &outline : snapshot->navOutlines)
     {
-        const auto &poly = snapshot->station->navPolygons[pIdx];
-
-        std::vector<Vector2> screenPoints;
-        for (int i = 0; i < 4; ++i)
-            screenPoints.push_back(GameManager::WorldToScreen(poly.vertices[i]));
-
-        // Draw outline
-        for (size_t i = 0; i < screenPoints.size(); ++i)
-            DrawLineEx(screenPoints[i], screenPoints[(i + 1) % screenPoints.size()], 2.f, Fade(ORANGE, .5f));
-
-        // Optional: Draw links between polygon centers
-        Vector2 center = GameManager::WorldToScreen(poly.GetCenter());
-        for (const auto &link : poly.links)
-            DrawLineEx(center, GameManager::WorldToScreen(snapshot->station->navPolygons[link.targetPolyIdx].GetCenter()), 1.f, Fade(YELLOW, .3f));
+        for (size_t i = 0; i < outline.size(); ++i)
+            DrawLineEx(GameManager::WorldToScreen(outline[i]), GameManager::WorldToScreen(outline[(i + 1) % outline.size()]), 2.f, Fade(ORANGE, .5f));
     }
 
+    // Links between polygon centers
+    for (const auto &[center, targetCenter] : snapshot->navLinks)
+        DrawLineEx(GameManager::WorldToScreen(center), GameManager::WorldToScreen(targetCenter), 1.f, Fade(YELLOW, .3f));
+
     if (GameManager::IsInBuildMode() && GameManager::IsHorizontalSymmetry())
     {
         Vector2 screenPos = GameManager::WorldToScreen(Vector2(0, 0));
@@ -311,33 +308,38 @@ void DrawStationOverlays()
  */
 void DrawEnvironmentalEffects()
 {
+    static const size_t profileSection = Profiler::AddSection("DrawEnvironmentalEffects", ProfileDomain::FRAME);
+    ScopedTimer timer(profileSection);
+
     auto snapshot = GameManager::GetRenderSnapshot();
-    if (!snapshot || !snapshot->station)
+    if (!snapshot || !snapshot->hasStation)
         return;
 
     // Collect current effect IDs for cleanup detection
     std::unordered_set<uint64_t> currentIds;
-    for (const auto &effect : snapshot->station->effects)
-        currentIds.insert(effect->GetInstanceId());
+    for (const auto &effect : snapshot->effects)
+        currentIds.insert(effect.instanceId);
 
     sol::state &lua = GameManager::GetLua();
     const float dt = GetFrameTime();
     const bool paused = GameManager::GetServer().IsGamePaused();
 
     // Ensure render systems exist for each active effect (create on first encounter)
-    for (const auto &effect : snapshot->station->effects)
+    for (const auto &effect : snapshot->effects)
     {
-        uint64_t id = effect->GetInstanceId();
+        uint64_t id = effect.instanceId;
         auto &vec = g_renderSystems[id];
 
         if (vec.empty())
         {
-            for (const auto &psDef : effect->GetEffectDefinition()->GetParticleSystems())
+            // Every system of the effect shares one copy of its state, so the Lua callbacks see it move and grow
+            auto effectRef = std::make_shared<EffectRender>(effect);
+            for (const auto &psDef : effect.definition->GetParticleSystems())
             {
                 RenderParticleSystem r;
                 r.system = std::make_shared<ParticleSystem>();
                 r.psysId = psDef.id;
-                r.effectRef = effect; // hold reference so render callbacks remain valid
+                r.effectRef = effectRef;
 
                 try
                 {
@@ -370,7 +372,7 @@ void DrawEnvironmentalEffects()
                 }
                 catch (const sol::error &e)
                 {
-                    throw std::runtime_error(std::string("Error compiling render Lua for effect '") + effect->GetEffectDefinition()->GetId() +
+                    throw std::runtime_error(std::string("Error compiling render Lua for effect '") + effect.definition->GetId() +
                                              "', particle system '" + psDef.id + "': " + e.what());
                 }
 
@@ -378,6 +380,9 @@ void DrawEnvironmentalEffects()
             }
         }
 
+        else
+            *vec.front().effectRef = effect;
+
         if (!paused)
         {
             for (auto &r : vec)
@@ -390,7 +395,7 @@ void DrawEnvironmentalEffects()
                     }
                     catch (const sol::error &e)
                     {
-                        throw std::runtime_error(std::string("Error in render Lua for effect '") + effect->GetEffectDefinition()->GetId() +
+                        throw std::runtime_error(std::string("Error in render Lua for effect '") + effect.definition->GetId() +
                                                  "', particle system '" + r.psysId + "' on_update: " + e.what());
                     }
                 }
@@ -468,7 +473,7 @@ void DrawEnvironmentalEffects()
     }
 }
 
-void DrawPawnSprite(const std::shared_ptr<const Pawn> &pawn, const Vector2 &drawPosition, bool isSelected, bool isMoving)
+void DrawPawnSprite(const PawnRender &pawn, const Vector2 &drawPosition, bool isSelected)
 {
     auto &camera = GameManager::GetCamera();
     Vector2 pawnScreenPos = GameManager::WorldToScreen(drawPosition);
@@ -483,19 +488,19 @@ void DrawPawnSprite(const std::shared_ptr<const Pawn> &pawn, const Vector2 &draw
     };
 
     float outlineOpacity = isSelected ? .75f : .5f;
-    bool isDead = !pawn->IsAlive();
+    bool isDead = !pawn.alive;
 
     if (isDead)
         DrawPawnOutline(pawnRadius * 1.25f, Fade(GRAY, outlineOpacity));
     else
-        DrawPawnOutline(pawnRadius * 1.25f, Fade(pawn->GetColor(), outlineOpacity));
+        DrawPawnOutline(pawnRadius * 1.25f, Fade(pawn.color, outlineOpacity));
 
     // Try to draw sprite, but fall back to circle on any error
     try
     {
         // Determine animation type
         PawnAnimationType animType = PawnAnimationType::IDLE;
-        if (!isDead && isMoving)
+        if (!isDead && pawn.moving)
             animType = PawnAnimationType::WALKING;
 
         // Get pawn definition
@@ -506,12 +511,13 @@ void DrawPawnSprite(const std::shared_ptr<const Pawn> &pawn, const Vector2 &draw
         // Get animation and frame
         float animSpeed = pawnDef->GetAnimationSpeed(animType);
 
-        // Update animation elapsed time
+        // Update animation elapsed time, kept here since only drawing uses it
+        float &animationTime = g_pawnAnimationTimes[pawn.id];
         if (!GameManager::GetServer().IsGamePaused())
-            pawn->AddAnimationElapsedTime(GetFrameTime());
-        size_t frameIndex = static_cast<size_t>(pawn->GetAnimationElapsedTime() / animSpeed);
+            animationTime += GetFrameTime();
+        size_t frameIndex = static_cast<size_t>(animationTime / animSpeed);
 
-        Vector2Int frameOffset = pawnDef->GetFrame(animType, pawn->GetFacingDirection(), frameIndex);
+        Vector2Int frameOffset = pawnDef->GetFrame(animType, pawn.facing, frameIndex);
 
         // Draw sprite from spritesheet
         Vector2 tileSize = Vector2(PAWN_DRAW_SIZE, PAWN_DRAW_SIZE) * camera.GetZoom();
@@ -523,7 +529,7 @@ void DrawPawnSprite(const std::shared_ptr<const Pawn> &pawn, const Vector2 &draw
     }
     catch (const std::exception &e)
     {
-        TraceLog(LOG_WARNING, "Error drawing pawn sprite: %s", e.what());
+        ASYNC_LOG(LOG_WARNING, "Error drawing pawn sprite: {}", e.what());
     }
 }
 
@@ -532,79 +538,41 @@ void DrawPawnSprite(const std::shared_ptr<const Pawn> &pawn, const Vector2 &draw
  */
 void DrawPawn()
 {
+    static const size_t profileSection = Profiler::AddSection("DrawPawn", ProfileDomain::FRAME);
+    ScopedTimer timer(profileSection);
+
     auto snapshot = GameManager::GetRenderSnapshot();
     if (!snapshot)
         return;
 
     auto &camera = GameManager::GetCamera();
+    const float interpolation = snapshot->GetInterpolation();
 
-    for (const auto &kv : snapshot->pawnList)
+    for (const auto &pawn : snapshot->pawns)
     {
-        const auto &pawn = kv.second;
-        Vector2 drawPosition = pawn->GetPosition();
-        auto &actionQueue = pawn->GetReadOnlyActionQueue();
-        bool isMoving = false;
-
-        if (!actionQueue.empty() && actionQueue.front()->GetType() == Action::Type::MOVE)
-        {
-            const auto moveAction = std::dynamic_pointer_cast<MoveAction>(actionQueue.front());
-            isMoving = moveAction && moveAction->IsMoving();
-
-            if (moveAction && !GameManager::IsInBuildMode() && !moveAction->path.empty())
-                DrawPath(moveAction->path, pawn->GetPosition());
-
-            if (isMoving && !GameManager::IsInBuildMode() && !moveAction->path.empty())
-            {
-                Vector2 nextPosition = moveAction->path.front();
-
-                const float moveDelta = static_cast<float>(snapshot->timeSinceFixedUpdate * PAWN_MOVE_SPEED);
-                const float distToNext = Vector2Distance(pawn->GetPosition(), nextPosition);
-
-                if (distToNext <= moveDelta)
-                {
-                    drawPosition = nextPosition;
-
-                    if (moveAction->path.size() > 1)
-                    {
-                        Vector2 futurePosition = moveAction->path.at(1);
-                        drawPosition += Vector2Normalize(futurePosition - drawPosition) * (moveDelta - distToNext);
-                    }
-                }
-                else
-                {
-                    bool canPath = true;
-                    if (auto tile = pawn->GetCurrentTile())
-                        if (std::shared_ptr<Station> station = tile->GetStation())
-                            canPath = station->IsDoorFullyOpenAtPos(ToVector2Int(nextPosition));
+        // Blend between the last two ticks instead of guessing ahead, so doors and path changes never overshoot
+        Vector2 drawPosition = Vector2Lerp(pawn.previousPosition, pawn.position, interpolation);
+        const auto path = snapshot->GetPath(pawn);
 
-                    if (canPath)
-                        drawPosition += Vector2Normalize(nextPosition - pawn->GetPosition()) * moveDelta;
-                }
-            }
-        }
+        if (!GameManager::IsInBuildMode() && !path.empty())
+            DrawPath(path, drawPosition);
 
         // Draw faint circles at planned move destinations
         if (!GameManager::IsInBuildMode())
         {
             float circleRadius = (PAWN_DRAW_SIZE * .25f) * camera.GetZoom();
-            for (const auto &action : actionQueue)
+            for (const auto &target : snapshot->GetMoveTargets(pawn))
             {
-                if (action && action->GetType() == Action::Type::MOVE)
-                {
-                    if (auto moveAct = std::dynamic_pointer_cast<MoveAction>(action))
-                    {
-                        Vector2 screenPos = GameManager::WorldToScreen(moveAct->targetPosition);
-                        // Faint filled circle
-                        DrawCircleV(screenPos, circleRadius, Fade(pawn->GetColor(), .15f));
-                        // Faint outline ring
-                        DrawRing(screenPos, circleRadius * .85f, circleRadius, 0.f, 360.f, 24, Fade(pawn->GetColor(), .4f));
-                    }
-                }
+                Vector2 screenPos = GameManager::WorldToScreen(target);
+                // Faint filled circle
+                DrawCircleV(screenPos, circleRadius, Fade(pawn.color, .15f));
+                // Faint outline ring
+                DrawRing(screenPos, circleRadius * .85f, circleRadius, 0.f, 360.f, 24, Fade(pawn.color, .4f));
             }
         }
 
-        bool isSelected = Find(GameManager::GetSelectedPawn(), pawn->GetInstanceId()).has_value();
-        DrawPawnSprite(pawn, drawPosition, isSelected, isMoving);
+        bool isSelected = Find(GameManager::GetSelectedPawn(), pawn.id).has_value();
+        DrawPawnSprite(pawn, drawPosition, isSelected);
     }
 }
 
@@ -614,45 +582,14 @@ void DrawPawnActionProgress()
     if (!snapshot)
         return;
 
-    for (const auto &kv : snapshot->pawnList)
+    for (const auto &pawn : snapshot->pawns)
     {
-        const auto &pawn = kv.second;
-        if (!pawn->IsAlive() || pawn->GetReadOnlyActionQueue().empty())
+        if (!pawn.alive || pawn.progressType == PawnProgress::NONE)
             continue;
 
-        const auto &action = pawn->GetReadOnlyActionQueue().front();
-
-        switch (action->GetType())
-        {
-        case Action::Type::EXTINGUISH:
-        {
-            const auto extinguishAction = std::dynamic_pointer_cast<ExtinguishAction>(action);
-
-            const Vector2 barPos = GameManager::WorldToScreen(ToVector2(extinguishAction->GetTargetPosition()) - Vector2(.5 - .05, .5 - .85));
-            const Vector2 barSize = Vector2(extinguishAction->GetProgress() * .9, .1) * TILE_SIZE * GameManager::GetCamera().GetZoom();
-            DrawRectangleV(barPos, barSize, Fade(RED, .8));
-        }
-        break;
-
-        case Action::Type::CONSTRUCTION:
-        {
-            const auto constructionAction = std::dynamic_pointer_cast<ConstructionAction>(action);
-            const std::shared_ptr<PlannedTask> planned = constructionAction->GetPlanned().lock();
-            if (!planned)
-                break;
-
-            const Vector2 barPos = GameManager::WorldToScreen(ToVector2(planned->position) - Vector2(.5 - .05, .5 - .85));
-            float progress = std::clamp(planned->progress, 0.f, 1.f);
-            progress = planned->isBuild ? progress : 1.f - progress;
-
-            const Vector2 fillSize = Vector2(progress * .9f, .1f) * TILE_SIZE * GameManager::GetCamera().GetZoom();
-            DrawRectangleV(barPos, fillSize, Fade(YELLOW, .8));
-        }
-        break;
-
-        default:
-            break;
-        }
+        const Vector2 barPos = GameManager::WorldToScreen(ToVector2(pawn.progressPosition) - Vector2(.5 - .05, .5 - .85));
+        const Vector2 barSize = Vector2(pawn.progress * .9f, .1f) * TILE_SIZE * GameManager::GetCamera().GetZoom();
+        DrawRectangleV(barPos, barSize, Fade(pawn.progressType == PawnProgress::EXTINGUISHING ? RED : YELLOW, .8));
     }
 }
 
@@ -680,7 +617,7 @@ void DrawDragSelectBox()
 }
 
 /**
- * Displays the current FPS in the top-right corner.
+ * Displays the current FPS in the top-right corner, and the simulation speed below it when not 1x.
  */
 void DrawFpsCounter()
 {
@@ -689,14 +626,148 @@ void DrawFpsCounter()
     std::string fpsText = std::format("FPS: {:} ({:.2f}ms)", GetFPS(), deltaTime * 1000.f);
     const char *text = fpsText.c_str();
     DrawTextEx(font, text, Vector2(GetScreenSize().x - MeasureTextEx(font, text, DEFAULT_FONT_SIZE, 1).x - DEFAULT_PADDING, DEFAULT_PADDING), DEFAULT_FONT_SIZE, 1, UI_TEXT_COLOR);
+
+    TimeScale timeScale = GameManager::GetServer().GetTimeScale();
+    if (timeScale == TimeScale::NORMAL)
+        return;
+
+    double factor = GetTimeScaleFactor(timeScale);
+    std::string speedText = factor > 0. ? std::format("Speed: {:.0f}x", factor) : "Speed: Max";
+    text = speedText.c_str();
+    float yOffset = DEFAULT_PADDING * 1.5f + DEFAULT_FONT_SIZE;
+    DrawTextEx(font, text, Vector2(GetScreenSize().x - MeasureTextEx(font, text, DEFAULT_FONT_SIZE, 1).x - DEFAULT_PADDING, yOffset), DEFAULT_FONT_SIZE, 1, UI_TEXT_COLOR);
+}
+
+/**
+ * Draws rolling timings of every profiled section, with a stacked graph of the phases of recent ticks.
+ */
+void DrawProfilerOverlay()
+{
+    if (!GameManager::GetCamera().IsOverlay(PlayerCam::Overlay::PROFILER))
+        return;
+
+    Font font = AssetManager::GetFont("DEFAULT");
+    const float lineHeight = DEFAULT_FONT_SIZE + DEFAULT_PADDING / 2;
+    const float budget = (float)(FIXED_DELTA_TIME * 1000.);
+    const size_t sectionCount = Profiler::GetSectionCount();
+
+    // Only whole ticks are graphed, so stop at the last tick every tick section has recorded
+    std::vector<size_t> phases;
+    size_t tickSection = SIZE_MAX;
+    uint64_t tickCount = UINT64_MAX;
+    for (size_t i = 0; i < sectionCount; ++i)
+    {
+        ProfileDomain domain = Profiler::GetSectionDomain(i);
+        if (domain == ProfileDomain::FRAME)
+            continue;
+        if (domain == ProfileDomain::TICK_PHASE)
+            phases.push_back(i);
+        else
+            tickSection = i;
+        tickCount = std::min(tickCount, Profiler::GetSampleCount(i));
+    }
+    auto getPhaseColor = [&phases](size_t phase)
+    { return ColorFromHSV(360.f * phase / phases.size(), .6f, .9f); };
+
+    std::vector<std::pair<std::string, Color>> lines;
+    lines.emplace_back(std::format("Tick budget: {:.2f}ms", budget), UI_TEXT_COLOR);
+
+    // Sections only keep allocations no nested section claimed, so the tick's sections add up to the whole tick
+    if (Profiler::COUNTS_ALLOCATIONS && tickCount > 0 && tickCount != UINT64_MAX)
+    {
+        AllocationCount lastTick;
+        for (size_t i = 0; i < sectionCount; ++i)
+        {
+            if (Profiler::GetSectionDomain(i) == ProfileDomain::FRAME)
+                continue;
+            AllocationCount sample = Profiler::GetAllocationSample(i, tickCount - 1);
+            lastTick.count += sample.count;
+            lastTick.bytes += sample.bytes;
+        }
+        lines.emplace_back(std::format("Allocations last tick: {} ({:.1f}KB)", lastTick.count, lastTick.bytes / 1024.f), UI_TEXT_COLOR);
+    }
+    for (ProfileDomain domain : {ProfileDomain::TICK, ProfileDomain::TICK_PHASE, ProfileDomain::FRAME})
+    {
+        size_t phase = 0;
+        for (size_t i = 0; i < sectionCount; ++i)
+        {
+            if (Profiler::GetSectionDomain(i) != domain)
+                continue;
+
+            ProfileStats stats = Profiler::GetStats(i);
+            Color color = domain == ProfileDomain::TICK_PHASE ? getPhaseColor(phase++) : UI_TEXT_COLOR;
+            std::string text = std::format("{}: {:.2f}ms avg, {:.2f}ms p99", Profiler::GetSectionName(i), stats.average, stats.p99);
+            if (Profiler::COUNTS_ALLOCATIONS)
+                text += std::format(", {:.1f} allocs ({:.1f}KB)", stats.allocations, stats.allocatedBytes / 1024.f);
+            lines.emplace_back(text, color);
+        }
+    }
+
+    const float barWidth = 2.f;
+    const Vector2 graphSize = Vector2(Profiler::HISTORY * barWidth, 8.f * DEFAULT_FONT_SIZE);
+    float width = graphSize.x;
+    for (const auto &[text, color] : lines)
+        width = std::max(width, MeasureTextEx(font, text.c_str(), DEFAULT_FONT_SIZE, 1).x);
+
+    Vector2 size = Vector2(width, lines.size() * lineHeight + graphSize.y) + Vector2(2, 3) * DEFAULT_PADDING;
+    Vector2 pos = Vector2(DEFAULT_PADDING, GetScreenSize().y - size.y - DEFAULT_PADDING);
+    DrawRectangleRec(Vector2ToRect(pos, size), Fade(BLACK, .6f));
+
+    Vector2 textPos = pos + Vector2(DEFAULT_PADDING, DEFAULT_PADDING);
+    for (const auto &[text, color] : lines)
+    {
+        DrawTextEx(font, text.c_str(), textPos, DEFAULT_FONT_SIZE, 1, color);
+        textPos.y += lineHeight;
+    }
+
+    if (phases.empty() || tickCount == 0)
+        return;
+
+    // Scale to the slowest kept tick, but never so far that the budget line leaves the graph
+    size_t kept = (size_t)std::min<uint64_t>(tickCount, Profiler::HISTORY);
+    uint64_t firstTick = tickCount - kept;
+    float scale = budget * 1.5f;
+    for (uint64_t tick = firstTick; tick < tickCount; ++tick)
+    {
+        float total = 0;
+        for (size_t section : phases)
+            total += Profiler::GetSample(section, tick);
+        if (tickSection != SIZE_MAX)
+            total = std::max(total, Profiler::GetSample(tickSection, tick));
+        scale = std::max(scale, total);
+    }
+
+    Vector2 graphPos = Vector2(textPos.x, textPos.y + DEFAULT_PADDING);
+    float bottom = graphPos.y + graphSize.y;
+    for (size_t i = 0; i < kept; ++i)
+    {
+        uint64_t tick = firstTick + i;
+        float x = graphPos.x + (Profiler::HISTORY - kept + i) * barWidth;
+        float y = bottom;
+        for (size_t phase = 0; phase < phases.size(); ++phase)
+        {
+            float height = Profiler::GetSample(phases[phase], tick) / scale * graphSize.y;
+            y -= height;
+            DrawRectangleV(Vector2(x, y), Vector2(barWidth, height), getPhaseColor(phase));
+        }
+
+        // Phases overlap, so the tick's wall time can sit below the top of its stack
+        if (tickSection != SIZE_MAX)
+        {
+            float tickY = bottom - Profiler::GetSample(tickSection, tick) / scale * graphSize.y;
+            DrawRectangleV(Vector2(x, tickY - 1.f), Vector2(barWidth, 2.f), WHITE);
+        }
+    }
+
+    float budgetY = bottom - budget / scale * graphSize.y;
+    DrawLineEx(Vector2(graphPos.x, budgetY), Vector2(graphPos.x + graphSize.x, budgetY), 2.f, RED);
 }
 
 void DrawResourceUI()
 {
     auto snapshot = GameManager::GetRenderSnapshot();
-    if (!snapshot || !snapshot->station)
+    if (!snapshot || !snapshot->hasStation)
         return;
-    auto station = snapshot->station;
     Font font = AssetManager::GetFont("DEFAULT");
     float yOffset = DEFAULT_PADDING;
 
@@ -705,7 +776,7 @@ void DrawResourceUI()
 
     for (const auto &[resourceId, resourceDef] : resourceDefs)
     {
-        int count = station->GetResourceCount(resourceId);
+        int count = snapshot->GetResourceCount(resourceId);
         std::string resourceText = std::format("{}: {}", MacroCaseToName(resourceId), count);
         const char *text = resourceText.c_str();
         DrawTextEx(font, text, Vector2(DEFAULT_PADDING, yOffset), DEFAULT_FONT_SIZE, 1, UI_TEXT_COLOR);
@@ -767,35 +838,34 @@ void DrawMainTooltip()
     if (!GameManager::IsInBuildMode())
     {
         Vector2 worldMousePos = GameManager::GetWorldMousePos() - Vector2(.5, .5);
-        auto hoveredPawn = snapshot->GetPawnAtPosition(worldMousePos);
-        for (const auto &pawn : hoveredPawn)
+        for (uint32_t slot : snapshot->GetPawnAtPosition(worldMousePos))
         {
             if (!hoverText.empty())
                 hoverText += "\n";
-            hoverText += pawn->GetInfo();
+            hoverText += snapshot->pawns[slot].GetInfo();
         }
     }
 
+    // Tile details are written by the simulation for the tile asked for, and show up a tick later
     Vector2Int tileHoverPos = GameManager::ScreenToTile(mousePos);
+    GameManager::SetInspectedTile(tileHoverPos);
 
-    if (snapshot->station)
+    if (snapshot->hasStation && snapshot->inspectedPosition == tileHoverPos)
     {
-        auto hoveredTiles = snapshot->station->GetTilesAtPosition(tileHoverPos);
-        for (const auto &tile : hoveredTiles)
+        for (const auto &tileInfo : snapshot->inspectedTileInfo)
         {
             if (!hoverText.empty())
                 hoverText += "\n";
-            hoverText += tile->GetInfo();
+            hoverText += tileInfo;
         }
 
         if (!GameManager::IsInBuildMode())
         {
-            auto hoveredEffects = snapshot->station->GetEffectsAtPosition(tileHoverPos);
-            for (const auto &effect : hoveredEffects)
+            for (const auto &effectInfo : snapshot->inspectedEffectInfo)
             {
                 if (!hoverText.empty())
                     hoverText += "\n";
-                hoverText += effect->GetInfo();
+                hoverText += effectInfo;
             }
         }
     }
@@ -823,29 +893,29 @@ void DrawBuildUi()
 
     float rotAngle = RotationToAngle(GameManager::GetBuildRotation());
     for (const auto &pos : GameManager::GetSymmetryPositions(cursorPos))
-        DrawTileDefGhost(tileDef, pos, Fade(WHITE, .5f), rotAngle, snapshot->station);
+        DrawTileDefGhost(tileDef, pos, Fade(WHITE, .5f), rotAngle, snapshot);
 }
 
 void DrawPlannedTasks()
 {
     auto snapshot = GameManager::GetRenderSnapshot();
-    if (!snapshot || !snapshot->station)
+    if (!snapshot || !snapshot->hasStation)
         return;
 
     Texture2D iconTileset = AssetManager::GetTexture("ICON");
     Vector2 tileSize = Vector2(1, 1) * TILE_SIZE * GameManager::GetCamera().GetZoom();
 
-    for (const auto &task : snapshot->station->plannedTasks)
+    for (const auto &task : snapshot->plannedTasks)
     {
-        if (task->isBuild)
+        if (task.isBuild)
         {
-            auto tileDef = DefinitionManager::GetTileDefinition(task->tileId);
+            auto tileDef = DefinitionManager::GetTileDefinition(task.tileId);
             if (tileDef)
-                DrawTileDefGhost(tileDef, task->position, Fade(WHITE, .4f), RotationToAngle(task->rotation), snapshot->station);
+                DrawTileDefGhost(tileDef, task.position, Fade(WHITE, .4f), RotationToAngle(task.rotation), snapshot);
         }
 
-        Rectangle sourceRect = (task->isBuild ? Rectangle(1, 1, 1, 1) : Rectangle(3, 1, 1, 1)) * TILE_SIZE;
-        Rectangle destRect = Vector2ToRect(GameManager::WorldToScreen(task->position) + tileSize / 4.f, tileSize / 2.f);
+        Rectangle sourceRect = (task.isBuild ? Rectangle(1, 1, 1, 1) : Rectangle(3, 1, 1, 1)) * TILE_SIZE;
+        Rectangle destRect = Vector2ToRect(GameManager::WorldToScreen(task.position) + tileSize / 4.f, tileSize / 2.f);
         DrawTexturePro(iconTileset, sourceRect, destRect, tileSize / 2.f, 0, Fade(WHITE, .4f));
     }
 }
@@ -860,6 +930,7 @@ void ClearRenderSystems()
         }
     }
     g_renderSystems.clear();
+    g_pawnAnimationTimes.clear();
 }
 
 void CreateStarfield(uint64_t seed)
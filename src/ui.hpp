@@ -1,9 +1,12 @@
 #pragma once
 #include "utils.hpp"
-#include <deque>
+#include <span>
 
+struct Sprite;
+
+void DrawSprite(const Sprite &sprite, const Vector2Int &position, const Color &tint, float rotation = 0);
 void DrawTileGrid();
-void DrawPath(const std::deque<Vector2Int> &path, const Vector2 &startPos);
+void DrawPath(std::span<const Vector2> path, const Vector2 &startPos);
 void DrawStationTiles();
 void DrawStationOverlays();
 void DrawEnvironmentalEffects();
@@ -11,6 +14,7 @@ void DrawPawn();
 void DrawPawnActionProgress();
 void DrawDragSelectBox();
 void DrawFpsCounter();
+void DrawProfilerOverlay();
 void DrawResourceUI();
 void DrawTooltip(const std::string &tooltip, const Vector2 &pos, float padding = DEFAULT_PADDING, int fontSize = DEFAULT_FONT_SIZE);
 void DrawMainTooltip();
@@ -1,19 +1,13 @@
-#include "action.hpp"
 #include "camera.hpp"
-#include "component.hpp"
 #include "def_manager.hpp"
-#include "env_effect.hpp"
 #include "game_server.hpp"
 #include "game_state.hpp"
-#include "pawn.hpp"
-#include "planned_task.hpp"
-#include "power_grid.hpp"
+#include "logger.hpp"
 #include "render_snapshot.hpp"
-#include "station.hpp"
-#include "tile.hpp"
+#include "tile_def.hpp"
 #include "update.hpp"
 
-void HandlePlaceTile(const std::shared_ptr<const Station> &station)
+void HandlePlaceTile(const RenderSnapshot &snapshot)
 {
     const std::string &tileIdToPlace = GameManager::GetBuildTileId();
     const auto &tileDefinition = DefinitionManager::GetTileDefinition(tileIdToPlace);
@@ -26,28 +20,28 @@ void HandlePlaceTile(const std::shared_ptr<const Station> &station)
     for (const auto &pos : posListToPlace)
     {
         // Don't plan if the same tile already exists at this position and height
-        if (auto t = station->GetTileAtPosition(pos, tileDefinition->GetHeight()))
+        if (auto t = snapshot.GetTileAtPosition(pos, tileDefinition->GetHeight()))
             if (t->GetId() == tileIdToPlace)
                 continue;
 
         GameManager::GetServer().RequestPlannedTask(pos, tileIdToPlace, true, GameManager::GetBuildRotation());
-        TraceLog(TraceLogLevel::LOG_INFO, std::format("Planned to place {} at {}", tileDefinition->GetName(), ToString(pos)).c_str());
+        ASYNC_LOG(LOG_INFO, "Planned to place {} at ({}, {})", tileDefinition->GetName(), pos.x, pos.y);
     }
 }
 
-void HandleDeleteTile(const std::shared_ptr<const Station> &station)
+void HandleDeleteTile(const RenderSnapshot &snapshot)
 {
     Vector2Int cursorPos = ToVector2Int(GameManager::GetWorldMousePos());
     std::vector<Vector2Int> posListToDelete = GameManager::GetSymmetryPositions(cursorPos);
 
     for (const auto &pos : posListToDelete)
     {
-        const auto &tilesAtPos = station->GetTilesAtPosition(pos);
+        auto tilesAtPos = snapshot.GetTilesAtPosition(pos);
         if (!tilesAtPos.empty())
         {
-            const auto &topTile = tilesAtPos.back();
-            GameManager::GetServer().RequestPlannedTask(pos, topTile->GetId(), false);
-            TraceLog(TraceLogLevel::LOG_INFO, std::format("Planned to remove {} at {}", topTile->GetId(), ToString(pos)).c_str());
+            const auto &topTile = snapshot.tiles[tilesAtPos.back().tile];
+            GameManager::GetServer().RequestPlannedTask(pos, topTile.GetId(), false);
+            ASYNC_LOG(LOG_INFO, "Planned to remove {} at ({}, {})", topTile.GetId(), pos.x, pos.y);
         }
     }
 }
@@ -55,10 +49,7 @@ void HandleDeleteTile(const std::shared_ptr<const Station> &station)
 void HandleBuildMode()
 {
     auto snapshot = GameManager::GetRenderSnapshot();
-    if (!snapshot)
-        return;
-    auto station = snapshot->station;
-    if (!station)
+    if (!snapshot || !snapshot->hasStation)
         return;
     // If we're in cancel mode, left-click cancels planned tasks (respecting symmetry)
     if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && GameManager::IsInCancelMode())
@@ -68,10 +59,10 @@ void HandleBuildMode()
 
         for (const auto &pos : posListToCancel)
         {
-            if (station->HasPlannedTaskAt(pos))
+            if (snapshot->HasPlannedTaskAt(pos))
             {
                 GameManager::GetServer().RequestCancelPlannedTask(pos);
-                TraceLog(TraceLogLevel::LOG_INFO, std::format("Canceled planned task at {}", ToString(pos)).c_str());
+                ASYNC_LOG(LOG_INFO, "Canceled planned task at ({}, {})", pos.x, pos.y);
             }
         }
 
@@ -87,10 +78,10 @@ void HandleBuildMode()
     }
 
     if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && !GameManager::GetBuildTileId().empty())
-        HandlePlaceTile(station);
+        HandlePlaceTile(*snapshot);
 
     if (IsMouseButtonPressed(MOUSE_RIGHT_BUTTON))
-        HandleDeleteTile(station);
+        HandleDeleteTile(*snapshot);
 }
 
 void HandlePawnHover()
@@ -98,21 +89,15 @@ void HandlePawnHover()
     auto snapshot = GameManager::GetRenderSnapshot();
     if (!snapshot)
         return;
-    const auto &pawnList = snapshot->pawnList;
     const Vector2 worldMousePos = GameManager::GetWorldMousePos() - Vector2(.5, .5);
     const float pawnRadius = (PAWN_DRAW_SIZE * .5f * 1.25f) / TILE_SIZE;
-    const float pawnRadiusSq = pawnRadius * pawnRadius;
 
     GameManager::ClearHoveredPawn();
 
-    for (const auto &entry : pawnList)
-    {
-        const auto &pawn = entry.second;
-        if (!pawn || Vector2DistanceSq(worldMousePos, pawn->GetPosition()) > pawnRadiusSq)
-            continue;
-
-        GameManager::AddHoveredPawn(pawn->GetInstanceId());
-    }
+    static std::vector<uint32_t> hoveredSlots;
+    snapshot->pawnGrid.QueryRadius(worldMousePos, pawnRadius, hoveredSlots);
+    for (uint32_t slot : hoveredSlots)
+        GameManager::AddHoveredPawn(snapshot->pawns[slot].id);
 }
 
 void HandleMouseDragStart()
@@ -167,16 +152,15 @@ void HandlePawnSelection()
         auto snapshot = GameManager::GetRenderSnapshot();
         if (!snapshot)
             return;
-        auto &pawnList = snapshot->pawnList;
-        for (const auto &entry : pawnList)
-        {
-            const auto &pawn = entry.second;
-            bool isWithinRect = IsVector2WithinRect(camera.GetDragRect(), pawn->GetPosition() + Vector2(.5, .5));
-            if (!pawn || !isWithinRect)
-                continue;
+        // Pawns are drawn centered on their tile, shift the box into position space instead
+        Rectangle selectRect = camera.GetDragRect();
+        selectRect.x -= .5f;
+        selectRect.y -= .5f;
 
-            GameManager::AddSelectedPawn(pawn->GetInstanceId());
-        }
+        static std::vector<uint32_t> selectedSlots;
+        snapshot->pawnGrid.QueryRect(selectRect, selectedSlots);
+        for (uint32_t slot : selectedSlots)
+            GameManager::AddSelectedPawn(snapshot->pawns[slot].id);
 
         return;
     }
@@ -188,149 +172,48 @@ void HandlePawnSelection()
     GameManager::ToggleSelectedPawn(hoveredPawn.at(0));
 }
 
-void AssignPawnActions()
+void HandleDoorLock()
 {
+    if (!IsKeyPressed(KEY_L))
+        return;
+
     auto snapshot = GameManager::GetRenderSnapshot();
     if (!snapshot)
         return;
 
-    const auto &selectedPawn = GameManager::GetSelectedPawn();
-    if (IsMouseButtonPressed(MOUSE_RIGHT_BUTTON) && !selectedPawn.empty())
-    {
-        Vector2Int worldPos = ToVector2Int(GameManager::GetWorldMousePos());
-
-        for (const auto pawnId : selectedPawn)
-        {
-            std::shared_ptr<const Pawn> snapshotPawn = nullptr;
-            auto itPawn = snapshot->pawnList.find(pawnId);
-            if (itPawn != snapshot->pawnList.end())
-                snapshotPawn = itPawn->second;
-
-            if (!snapshotPawn || !snapshotPawn->IsAlive() || !snapshotPawn->GetCurrentTile())
-                continue;
-
-            if (!IsKeyDown(KEY_LEFT_SHIFT))
-                GameManager::GetServer().ClearPawnActions(snapshotPawn->GetInstanceId());
-
-            GameManager::GetServer().SendPlayerAction(snapshotPawn->GetInstanceId(), std::make_unique<MoveAction>(ToVector2(worldPos)));
-        }
-    }
-}
-
-void HandlePawnActions()
-{
-    const auto &pawnList = GameManager::GetServer().GetPawnList();
-    for (const auto &entry : pawnList)
-    {
-        const auto &pawn = entry.second;
-        if (!pawn->IsAlive() || pawn->GetActionQueue().empty())
-            continue;
-
-        const auto &currentAction = pawn->GetActionQueue().front();
-        if (currentAction->Update(pawn))
-            pawn->RemoveFirstAction();
-    }
-}
-
-void HandlePawnEnvironment()
-{
-    const auto &pawnList = GameManager::GetServer().GetPawnList();
-    for (const auto &entry : pawnList)
+    Vector2Int cursorPos = ToVector2Int(GameManager::GetWorldMousePos());
+    for (const auto &tileAtPos : snapshot->GetTilesAtPosition(cursorPos))
     {
-        const auto &pawn = entry.second;
-        if (!pawn->IsAlive())
-            continue;
-
-        pawn->ConsumeOxygen(FIXED_DELTA_TIME);
-        auto tile = pawn->GetCurrentTile();
-        if (!tile)
-            continue;
-
-        if (auto oxygen = tile->GetComponent<OxygenComponent>())
-            pawn->RefillOxygen(FIXED_DELTA_TIME, oxygen->GetOxygenLevel());
-
-        if (auto tileStation = tile->GetStation())
+        if (snapshot->tiles[tileAtPos.tile].Has(TileRenderFlags::DOOR))
         {
-            auto effects = tileStation->GetEffectsAtPosition(tile->GetPosition());
-            for (const auto &effect : effects)
-                effect->EffectPawn(pawn, FIXED_DELTA_TIME);
+            GameManager::GetServer().RequestToggleDoorLock(cursorPos);
+            return;
         }
     }
 }
 
-void UpdatePawnCurrentTile()
-{
-    auto station = GameManager::GetServer().GetStation();
-    if (!station || station->tileMap.empty())
-        return;
-
-    const auto &pawnList = GameManager::GetServer().GetPawnList();
-    for (const auto &entry : pawnList)
-    {
-        const auto &pawn = entry.second;
-        if (!pawn->IsAlive())
-            continue;
-
-        Vector2Int floorPawnPos = ToVector2Int(pawn->GetPosition());
-
-        if (pawn->GetCurrentTile() && pawn->GetCurrentTile()->GetPosition() == floorPawnPos)
-            continue;
-
-        pawn->SetCurrentTile(station->GetTileAtPosition(floorPawnPos, TileHeight::FLOOR));
-    }
-}
-
-void UpdatePowerGrids()
+void AssignPawnActions()
 {
-    auto station = GameManager::GetServer().GetStation();
-    if (!station)
+    auto snapshot = GameManager::GetRenderSnapshot();
+    if (!snapshot)
         return;
 
-    for (const auto &powerGrid : station->powerGrids)
+    const auto &selectedPawn = GameManager::GetSelectedPawn();
+    if (IsMouseButtonPressed(MOUSE_RIGHT_BUTTON) && !selectedPawn.empty())
     {
-        powerGrid->Update(FIXED_DELTA_TIME);
-    }
-}
-
-void UpdateTiles()
-{
-    auto station = GameManager::GetServer().GetStation();
-    if (!station)
-        return;
-
-    std::unordered_set<std::shared_ptr<Tile>> updatedTiles;
+        Vector2Int worldPos = ToVector2Int(GameManager::GetWorldMousePos());
 
-    for (const auto &tilesAtPos : station->tileMap)
-    {
-        for (const auto &tile : tilesAtPos.second)
+        for (const auto pawnId : selectedPawn)
         {
-            if (updatedTiles.contains(tile))
+            auto slot = snapshot->FindPawnSlot(pawnId);
+            if (!slot || !snapshot->pawns[*slot].alive ||
+                !snapshot->GetTileAtPosition(ToVector2Int(snapshot->pawns[*slot].position), TileHeight::FLOOR))
                 continue;
-            updatedTiles.insert(tile);
-
-            if (auto door = tile->GetComponent<DoorComponent>())
-            {
-                door->Animate(FIXED_DELTA_TIME);
-            }
 
-            if (auto oxygenProducer = tile->GetComponent<OxygenProducerComponent>())
-                oxygenProducer->ProduceOxygen(FIXED_DELTA_TIME);
+            if (!IsKeyDown(KEY_LEFT_SHIFT))
+                GameManager::GetServer().ClearPawnActions(pawnId);
 
-            if (auto oxygen = tile->GetComponent<OxygenComponent>())
-                oxygen->Diffuse(FIXED_DELTA_TIME);
+            GameManager::GetServer().RequestPawnMove(pawnId, ToVector2(worldPos));
         }
     }
 }
-
-void UpdateEnvironmentalEffects()
-{
-    auto station = GameManager::GetServer().GetStation();
-    if (!station)
-        return;
-
-    for (int i = station->effects.size() - 1; i >= 0; --i)
-    {
-        auto &effect = station->effects.at(i);
-        effect->Update(station, i);
-    }
-}
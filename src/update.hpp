@@ -4,10 +4,5 @@ void HandleBuildMode();
 void HandlePawnHover();
 void HandleMouseDrag();
 void HandlePawnSelection();
+void HandleDoorLock();
 void AssignPawnActions();
-void HandlePawnActions();
-void HandlePawnEnvironment();
-void UpdatePawnCurrentTile();
-void UpdatePowerGrids();
-void UpdateTiles();
-void UpdateEnvironmentalEffects();
@@ -30,12 +30,13 @@ constexpr int GetEvenlySpacedIndex(double value, int index) noexcept
  * @param min The minimum value of the range.
  * @param max The maximum value of the range.
  * @return A random integer between min and max, inclusive.
+ * @note Differs every run. Anything the simulation depends on draws from a RandomStream instead.
  */
 inline int RandomIntWithRange(int min, int max) noexcept
 {
     if (max <= min)
         return min;
-    thread_local static std::random_device rd; // TODO: Switch to shared seed for multiplayer
+    thread_local static std::random_device rd;
     thread_local static std::mt19937 generator(rd());
     std::uniform_int_distribution<int> distribution(min, max);
 
@@ -68,27 +69,6 @@ constexpr int Floor(T value) noexcept
     return static_cast<int>(value) - ((value >= 0) ? 0 : 1);
 }
 
-/**
- * @brief Determines if an event occurs based on a chance per second and delta time.
- *
- * @param chancePerSecond The probability of the event occurring per second.
- * @param deltaTime The time elapsed since the last check, in seconds.
- * @return true if the event occurs, false otherwise.
- */
-inline bool CheckIfEventHappens(double chancePerSecond, double deltaTime) noexcept
-{
-    thread_local static std::random_device rd; // TODO: Switch to shared seed for multiplayer
-    thread_local static std::mt19937 gen(rd());
-    std::uniform_real_distribution<> dis(0.f, 1.f);
-
-    double expectedEvents = chancePerSecond * deltaTime;
-
-    if (expectedEvents >= 1.f)
-        return true;
-
-    return dis(gen) < expectedEvents;
-}
-
 /**
  * @brief Converts a float value to a string with a specified precision.
  *
@@ -208,7 +188,8 @@ namespace std
     {
         constexpr std::size_t operator()(const Vector2Int &v) const noexcept
         {
-            return std::hash<int>()(v.x) ^ (std::hash<int>()(v.y) << 1);
+            // Both coordinates keep all their bits, xor-ing them put a whole station grid into a few hundred buckets
+            return std::hash<uint64_t>()((uint64_t)(uint32_t)v.x << 32 | (uint32_t)v.y);
         }
     };
 }
@@ -379,5 +360,37 @@ constexpr std::string EnumToName(const T &enumValue)
     return MacroCaseToName(std::string(magic_enum::enum_name(enumValue)));
 }
 
+/**
+ * @brief Quotes a name for JSON. Names come from code and config, so only quotes and backslashes need escaping.
+ */
+constexpr std::string QuoteJson(const std::string &text) noexcept
+{
+    std::string quoted = "\"";
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+            quoted += '\\';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+// Utility functions for hashing
+constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+/**
+ * @brief Folds bytes into a 64-bit FNV-1a hash. Unlike std::hash, the result is the same in every run and build.
+ *
+ * @param hash The hash to continue from, so several values can be folded in one after another.
+ */
+inline uint64_t HashBytes(const void *data, size_t size, uint64_t hash = FNV_OFFSET_BASIS) noexcept
+{
+    const auto *bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; ++i)
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    return hash;
+}
+
 // Utility functions for Color
 Color RandomColor();
\ No newline at end of file
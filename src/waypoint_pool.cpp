@@ -0,0 +1,23 @@
+#include "waypoint_pool.hpp"
+
+std::vector<Vector2> *WaypointPool::Acquire()
+{
+    auto &pool = GetInstance();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+
+    if (pool.freeBuffers.empty())
+        return pool.buffers.emplace_back(std::make_unique<std::vector<Vector2>>()).get();
+
+    std::vector<Vector2> *buffer = pool.freeBuffers.back();
+    pool.freeBuffers.pop_back();
+    return buffer;
+}
+
+void WaypointPool::Release(std::vector<Vector2> *buffer)
+{
+    buffer->clear();
+
+    auto &pool = GetInstance();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    pool.freeBuffers.push_back(buffer);
+}
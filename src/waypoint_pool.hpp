@@ -0,0 +1,69 @@
+#pragma once
+#include "utils.hpp"
+#include <mutex>
+#include <span>
+#include <utility>
+
+/**
+ * @brief Recycles waypoint buffers between move actions.
+ * A finished move returns its buffer with its capacity intact, so planning the next path
+ * reuses that memory instead of allocating.
+ */
+struct WaypointPool
+{
+private:
+    std::vector<std::unique_ptr<std::vector<Vector2>>> buffers;
+    std::vector<std::vector<Vector2> *> freeBuffers;
+    std::mutex mutex;
+
+    WaypointPool() = default;
+    WaypointPool(const WaypointPool &) = delete;
+    WaypointPool &operator=(const WaypointPool &) = delete;
+
+    static WaypointPool &GetInstance()
+    {
+        // Never destroyed, actions owned by other singletons release their buffers during shutdown
+        static WaypointPool *instance = new WaypointPool();
+        return *instance;
+    }
+
+public:
+    static std::vector<Vector2> *Acquire();
+    static void Release(std::vector<Vector2> *buffer);
+};
+
+/**
+ * @brief Owning handle to a pooled waypoint buffer, acquired on first write.
+ */
+struct WaypointBuffer
+{
+private:
+    std::vector<Vector2> *buffer = nullptr;
+
+public:
+    WaypointBuffer() = default;
+    WaypointBuffer(const WaypointBuffer &) = delete;
+    WaypointBuffer &operator=(const WaypointBuffer &) = delete;
+    WaypointBuffer(WaypointBuffer &&other) noexcept : buffer(std::exchange(other.buffer, nullptr)) {}
+    WaypointBuffer &operator=(WaypointBuffer &&other) noexcept
+    {
+        std::swap(buffer, other.buffer);
+        return *this;
+    }
+    ~WaypointBuffer()
+    {
+        if (buffer)
+            WaypointPool::Release(buffer);
+    }
+
+    std::vector<Vector2> &Get()
+    {
+        if (!buffer)
+            buffer = WaypointPool::Acquire();
+        return *buffer;
+    }
+
+    size_t Size() const { return buffer ? buffer->size() : 0; }
+    const Vector2 &operator[](size_t index) const { return (*buffer)[index]; }
+    std::span<const Vector2> View() const { return buffer ? std::span<const Vector2>(*buffer) : std::span<const Vector2>(); }
+};
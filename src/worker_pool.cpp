@@ -0,0 +1,223 @@
+#include "profiler.hpp"
+#include "tracer.hpp"
+#include "worker_pool.hpp"
+#include <algorithm>
+#include <utility>
+
+// Deque of the running thread, workers have their own and every other thread shares the first
+static thread_local size_t currentQueue = 0;
+
+void JobGroup::Run(std::function<void()> job)
+{
+    pending.fetch_add(1, std::memory_order_relaxed);
+    WorkerPool::GetInstance().Push({std::move(job), this, Profiler::GetCurrentSection()});
+}
+
+void JobGroup::Wait()
+{
+    WaitForJobs();
+
+    std::lock_guard<std::mutex> lock(exceptionMutex);
+    if (firstException)
+        std::rethrow_exception(std::exchange(firstException, nullptr));
+}
+
+void JobGroup::WaitForJobs()
+{
+    auto &pool = WorkerPool::GetInstance();
+    TraceZone zone("WaitForJobs");
+    int idleYields = 0;
+    while (pending.load(std::memory_order_acquire) > 0)
+    {
+        // Help with whatever is queued; the jobs left are running on other threads otherwise
+        if (pool.RunOne())
+        {
+            idleYields = 0;
+            continue;
+        }
+        if (++idleYields <= YIELDS_BEFORE_SLEEP)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Woken by the group's last job finishing, or by a new job to help with
+        std::unique_lock<std::mutex> lock(pool.sleepMutex);
+        pool.wakeCondition.wait(lock, [this, &pool]()
+                                { return pending.load(std::memory_order_acquire) == 0 || pool.queuedJobs > 0; });
+        idleYields = 0;
+    }
+}
+
+void JobGroup::Finish(std::exception_ptr exception)
+{
+    if (exception)
+    {
+        std::lock_guard<std::mutex> lock(exceptionMutex);
+        if (!firstException)
+            firstException = exception;
+    }
+    if (pending.fetch_sub(1, std::memory_order_acq_rel) > 1)
+        return;
+
+    // The group may be gone once a waiter sees it done, so only the pool is touched from here on.
+    // Taking the lock orders this with a waiter checking pending before it sleeps
+    auto &pool = WorkerPool::GetInstance();
+    {
+        std::lock_guard<std::mutex> lock(pool.sleepMutex);
+    }
+    pool.wakeCondition.notify_all();
+}
+
+WorkerPool::WorkerPool()
+{
+    unsigned int threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    for (unsigned int i = 0; i < threadCount; ++i)
+        queues.push_back(std::make_unique<JobQueue>());
+
+    for (unsigned int i = 1; i < threadCount; ++i)
+        workers.emplace_back([this, i]()
+                             { WorkerLoop(i); });
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+
+    for (auto &worker : workers)
+        worker.join();
+}
+
+void WorkerPool::WorkerLoop(size_t queueIndex)
+{
+    currentQueue = queueIndex;
+    Tracer::SetThreadName(std::format("Worker {}", queueIndex));
+    while (true)
+    {
+        if (RunOne())
+            continue;
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeCondition.wait(lock, [this]()
+                           { return stopping || queuedJobs > 0; });
+        if (stopping)
+            return;
+    }
+}
+
+void WorkerPool::Push(Job &&job)
+{
+    {
+        auto &queue = *queues[currentQueue];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+
+        // Counted before the queue unlocks, so a thief can never take the job before it is counted
+        std::lock_guard<std::mutex> sleepLock(sleepMutex);
+        ++queuedJobs;
+    }
+    wakeCondition.notify_one();
+}
+
+bool WorkerPool::TryPop(Job &job)
+{
+    // Own jobs newest first, they are the most likely to still be in cache
+    {
+        auto &queue = *queues[currentQueue];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty())
+        {
+            job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+            --queuedJobs;
+            return true;
+        }
+    }
+
+    // Steal the oldest job of another thread, which tends to be the largest piece of work left
+    for (size_t i = 1; i < queues.size(); ++i)
+    {
+        auto &queue = *queues[(currentQueue + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty())
+        {
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+            --queuedJobs;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkerPool::RunOne()
+{
+    Job job;
+    if (queuedJobs == 0 || !TryPop(job))
+        return false;
+
+    size_t previousSection = Profiler::SwapCurrentSection(job.profileSection);
+    std::exception_ptr exception;
+    try
+    {
+        TraceZone zone("Job");
+        job.function();
+    }
+    catch (...)
+    {
+        exception = std::current_exception();
+    }
+
+    // Settled before the group hears the job is done, so the section's totals are complete when it waits
+    Profiler::SwapCurrentSection(previousSection);
+    job.group->Finish(exception);
+    return true;
+}
+
+void WorkerPool::ParallelFor(size_t count, size_t chunkSize, const std::function<void(size_t begin, size_t end, size_t chunk)> &body)
+{
+    if (count == 0)
+        return;
+
+    size_t chunkCount = GetChunkCount(count, chunkSize);
+    size_t threadCount = GetThreadCount();
+    if (chunkCount == 1 || threadCount == 1)
+    {
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+            body(chunk * chunkSize, std::min((chunk + 1) * chunkSize, count), chunk);
+        return;
+    }
+
+    // Every job claims chunks until none are left, so a job stolen late finds little to do
+    std::atomic<size_t> nextChunk = 0;
+    auto runChunks = [&]()
+    {
+        for (size_t chunk = nextChunk.fetch_add(1); chunk < chunkCount; chunk = nextChunk.fetch_add(1))
+        {
+            size_t begin = chunk * chunkSize;
+            body(begin, std::min(begin + chunkSize, count), chunk);
+        }
+    };
+
+    JobGroup group;
+    for (size_t i = 1; i < std::min(chunkCount, threadCount); ++i)
+        group.Run(runChunks);
+
+    std::exception_ptr callerException;
+    try
+    {
+        runChunks();
+    }
+    catch (...)
+    {
+        callerException = std::current_exception();
+    }
+
+    group.Wait();
+    if (callerException)
+        std::rethrow_exception(callerException);
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief A set of jobs that can be waited on together.
+ * Jobs may add more jobs to the group while it runs; Wait returns once all of them are done.
+ */
+class JobGroup
+{
+public:
+    JobGroup() = default;
+    JobGroup(const JobGroup &) = delete;
+    JobGroup &operator=(const JobGroup &) = delete;
+    ~JobGroup() { WaitForJobs(); }
+
+    /**
+     * @brief Queues a job on the calling thread's deque, where idle workers can steal it.
+     */
+    void Run(std::function<void()> job);
+
+    /**
+     * @brief Runs queued jobs, this group's or any other, until every job of the group is done.
+     * Sleeps while the group's last jobs run on other threads and nothing else is queued.
+     * Rethrows the first exception thrown by a job of the group.
+     */
+    void Wait();
+
+private:
+    friend struct WorkerPool;
+
+    static constexpr int YIELDS_BEFORE_SLEEP = 64; // Jobs left to others often finish soon, sleeping and waking costs more
+
+    std::atomic<size_t> pending = 0;
+    std::mutex exceptionMutex;
+    std::exception_ptr firstException;
+
+    void WaitForJobs();
+    void Finish(std::exception_ptr exception);
+};
+
+/**
+ * @brief Work-stealing job system on persistent worker threads.
+ * Every worker owns a deque: it pushes and pops its own jobs at the back, idle workers steal from the front.
+ * Threads outside the pool share one extra deque. Threads waiting on a group run jobs instead of blocking,
+ * so jobs can wait on jobs of their own.
+ */
+struct WorkerPool
+{
+private:
+    struct Job
+    {
+        std::function<void()> function;
+        JobGroup *group;
+        size_t profileSection; // Of the thread that queued the job, so its allocations count there
+    };
+
+    struct JobQueue
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<JobQueue>> queues; // Index 0 is shared by threads outside the pool
+
+    std::mutex sleepMutex;
+    std::condition_variable wakeCondition;
+    std::atomic<size_t> queuedJobs = 0;
+    bool stopping = false;
+
+    WorkerPool();
+    ~WorkerPool();
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    static WorkerPool &GetInstance()
+    {
+        static WorkerPool instance;
+        return instance;
+    }
+
+    void WorkerLoop(size_t queueIndex);
+    void Push(Job &&job);
+    bool TryPop(Job &job);
+
+    /**
+     * @return false if there was no job to run anywhere.
+     */
+    bool RunOne();
+
+    friend class JobGroup;
+
+public:
+    static size_t GetThreadCount() { return GetInstance().workers.size() + 1; }
+    static size_t GetChunkCount(size_t count, size_t chunkSize) { return (count + chunkSize - 1) / chunkSize; }
+
+    /**
+     * @brief Runs body(begin, end, chunkIndex) over [0, count) split into chunks of chunkSize.
+     * Chunk boundaries depend only on count and chunkSize, so output kept per chunk and merged
+     * in chunk order is the same no matter which thread ran which chunk.
+     * May be called from inside a job. Rethrows the first exception thrown by the body.
+     */
+    static void ParallelFor(size_t count, size_t chunkSize, const std::function<void(size_t begin, size_t end, size_t chunk)> &body);
+};